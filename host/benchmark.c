@@ -0,0 +1,322 @@
+/*******************************************************************************
+   Filename: benchmark.c
+
+     Author: David C. Drake (https://davidcdrake.com)
+
+Description: Render benchmark for MazeCrawler's 3D view, built against the
+             host-side stand-in for the Pebble SDK (see "host/Makefile").
+             Generates a series of mazes and draws every open cell's view in
+             every direction via "draw_scene" (with the frame cache cleared
+             first, so each frame is drawn from scratch), then reports the
+             median, 99th-percentile and worst-case time, pixels touched and
+             SDK draw calls per frame, along with the time spent building the
+             frame's display lists alone (i.e., the maze lookups and occlusion
+             tests of "build_display_list", without any drawing; the raycaster
+             has no display lists, so that's left out for it):
+
+                 benchmark [--engine <grid|raycast>] <no. of mazes>
+                           [<repetitions>]
+
+             Pixels touched are those drawn through the SDK plus those changed
+             directly in the captured frame buffer; draw calls are the SDK's
+             drawing functions (pixels, lines, rectangles, circles, paths and
+             bitmaps).
+
+             The views are drawn by the given render engine (default: the
+             platform's "DEFAULT_RENDER_ENGINE"), so the engines can be
+             compared (see "make bench-engines", which also builds the
+             raycaster for aplite, where the app leaves it out).
+
+             Each view is drawn "repetitions" times (default: 3) and its
+             fastest time kept, which filters out most scheduling noise.
+             Mazes are generated as in "render.c", so the same views are
+             measured every run. Times are for the host, of course, not the
+             watch; they're for comparing one version of the renderer with
+             another.
+*******************************************************************************/
+
+#include <time.h>
+
+#include "pebble_host.h"
+#define main maze_crawler_main  // The app's "main" is renamed in this build.
+#include "maze_crawler.h"
+#undef main
+
+#define BENCHMARK_USAGE             "usage: benchmark [--engine <grid|raycast>] <no. of mazes> [<repetitions>]\n"
+#define BENCHMARK_DEFAULT_REPETITIONS 3
+#define NANOSECONDS_PER_SECOND      1000000000ULL
+#define NANOSECONDS_PER_MICROSECOND 1000.0
+#define PERCENTILE(values, n, p)    ((values)[((n) - 1) * (p) / 100])  // Of sorted values.
+
+// Measurements of a single frame:
+typedef struct FrameStats {
+  uint64_t time,  // Nanoseconds.
+           lookup_time,  // Nanoseconds spent in "build_display_list".
+           pixels,
+           draw_calls;
+} frame_stats_t;
+
+void draw_view(const GPoint position, const int8_t direction);
+void build_display_lists(const GPoint position, const int8_t direction);
+uint64_t get_time_in_ns(void);
+void print_summary(const char *const label,
+                   uint64_t *const values,
+                   const size_t num_values,
+                   const double scale,
+                   const char *const units);
+int compare_values(const void *a, const void *b);
+
+/*******************************************************************************
+   Function: main
+
+Description: Parses the command line, starts the app, selects the requested
+             render engine, measures every view of the requested no. of mazes
+             and prints a summary.
+
+     Inputs: argc - No. of command-line arguments.
+             argv - Command-line arguments (see above).
+
+    Outputs: Exit status (non-zero if the arguments are invalid).
+*******************************************************************************/
+int main(int argc, char **argv) {
+  uint32_t seed;
+  int num_mazes, num_repetitions, i;
+  int8_t x, y, direction, engine = DEFAULT_RENDER_ENGINE;
+  size_t num_frames = 0, max_frames = 0, j;
+  uint64_t start_time, time, *times, *lookup_times, *pixels,
+           *draw_calls;
+  frame_stats_t *frames = NULL;
+
+  if (argc >= 3 && strcmp(argv[1], "--engine") == 0) {
+    engine = host_get_render_engine(argv[2]);
+#ifndef RAYCASTING_ENGINE_ENABLED
+    if (engine == RAYCASTING_ENGINE) {
+      engine = -1;  // Compiled out (see "RAYCASTING_ENGINE_ENABLED").
+    }
+#endif
+    argc -= 2;
+    argv += 2;
+  }
+  if (argc < 2 || argc > 3 || engine < 0) {
+    fprintf(stderr, BENCHMARK_USAGE);
+
+    return 1;
+  }
+  num_mazes = atoi(argv[1]);
+  num_repetitions = argc == 3 ? atoi(argv[2]) :
+                                BENCHMARK_DEFAULT_REPETITIONS;
+  if (num_mazes < 1 || num_repetitions < 1) {
+    fprintf(stderr, BENCHMARK_USAGE);
+
+    return 1;
+  }
+  init();
+  window_stack_push(g_graphics_window, NOT_ANIMATED);
+  host_init();
+  g_host_count_capture_pixels = true;
+  g_render_engine = engine;
+  clear_frame_cache();  // (It isn't keyed by engine.)
+
+  // Draw every view, keeping each one's fastest time:
+  for (seed = 1; seed <= (uint32_t) num_mazes; ++seed) {
+    begin_maze_generation(seed);
+    init_maze();
+    for (x = 0; x < g_maze->width; ++x) {
+      for (y = 0; y < g_maze->height; ++y) {
+        if (is_solid(GPoint(x, y))) {
+          continue;
+        }
+        for (direction = 0; direction < NUM_DIRECTIONS; ++direction) {
+          if (num_frames == max_frames) {
+            max_frames = max_frames == 0 ? 1024 : max_frames * 2;
+            frames = realloc(frames, max_frames * sizeof(frame_stats_t));
+          }
+          for (i = 0; i < num_repetitions; ++i) {
+            memset(&g_host_stats, 0, sizeof(g_host_stats));
+            start_time = get_time_in_ns();
+            draw_view(GPoint(x, y), direction);
+            time = get_time_in_ns() - start_time;
+            if (i == 0 || time < frames[num_frames].time) {
+              frames[num_frames].time = time;
+            }
+          }
+          for (i = 0;
+               i < num_repetitions && engine != RAYCASTING_ENGINE;
+               ++i) {
+            start_time = get_time_in_ns();
+            build_display_lists(GPoint(x, y), direction);
+            time = get_time_in_ns() - start_time;
+            if (i == 0 || time < frames[num_frames].lookup_time) {
+              frames[num_frames].lookup_time = time;
+            }
+          }
+          frames[num_frames].pixels = g_host_stats.pixels_drawn;
+          frames[num_frames].draw_calls = g_host_stats.pixel_calls +
+                                          g_host_stats.line_calls +
+                                          g_host_stats.rect_calls +
+                                          g_host_stats.circle_calls +
+                                          g_host_stats.path_calls +
+                                          g_host_stats.bitmap_calls;
+          num_frames++;
+        }
+      }
+    }
+  }
+
+  // Summarize each measurement:
+  times = malloc(num_frames * sizeof(uint64_t));
+  lookup_times = malloc(num_frames * sizeof(uint64_t));
+  pixels = malloc(num_frames * sizeof(uint64_t));
+  draw_calls = malloc(num_frames * sizeof(uint64_t));
+  for (j = 0; j < num_frames; ++j) {
+    times[j] = frames[j].time;
+    lookup_times[j] = frames[j].lookup_time;
+    pixels[j] = frames[j].pixels;
+    draw_calls[j] = frames[j].draw_calls;
+  }
+  printf("%s (%dx%d, %s), %s engine, %d maze(s), %zu frames, best of %d:\n",
+         HOST_PLATFORM_NAME,
+         PBL_DISPLAY_WIDTH,
+         PBL_DISPLAY_HEIGHT,
+         PBL_IF_COLOR_ELSE("color", "1-bit"),
+         g_host_render_engine_names[engine],
+         num_mazes,
+         num_frames,
+         num_repetitions);
+  print_summary("time", times, num_frames, NANOSECONDS_PER_MICROSECOND, "us");
+  if (engine != RAYCASTING_ENGINE) {
+    print_summary("lookups", lookup_times, num_frames, 1.0, "ns");
+  }
+  print_summary("pixels", pixels, num_frames, 1.0, "");
+  print_summary("draw calls", draw_calls, num_frames, 1.0, "");
+  free(times);
+  free(lookup_times);
+  free(pixels);
+  free(draw_calls);
+  free(frames);
+
+  return 0;
+}
+
+/*******************************************************************************
+   Function: draw_view
+
+Description: Moves the player to a given cell and direction and draws the 3D
+             view from scratch (i.e., just the scene layer, with the frame
+             cache cleared).
+
+     Inputs: position  - Cell to view the maze from.
+             direction - Direction to face.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_view(const GPoint position, const int8_t direction) {
+  g_player->position = position;
+  g_player->direction = direction;
+  g_scene_dirty = true;
+  clear_frame_cache();
+  host_render_layer(g_scene_layer,
+                    GPointZero,
+                    GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+}
+
+/*******************************************************************************
+   Function: build_display_lists
+
+Description: Moves the player to a given cell and direction and builds the
+             display list of each depth in turn, as "draw_scene" would, but
+             without drawing anything (so no columns are ever covered).
+
+     Inputs: position  - Cell to view the maze from.
+             direction - Direction to face.
+
+    Outputs: None.
+*******************************************************************************/
+void build_display_lists(const GPoint position, const int8_t direction) {
+  int8_t depth;
+
+  g_player->position = position;
+  g_player->direction = direction;
+  memset(g_column_coverage, 0, sizeof(g_column_coverage));
+  for (depth = 0; depth < MAX_VISIBILITY_DEPTH; ++depth) {
+    if (!build_display_list(depth)) {
+      break;
+    }
+  }
+}
+
+/*******************************************************************************
+   Function: get_time_in_ns
+
+Description: Returns the host's monotonic clock, in nanoseconds.
+
+     Inputs: None.
+
+    Outputs: The current time, in nanoseconds.
+*******************************************************************************/
+uint64_t get_time_in_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+/*******************************************************************************
+   Function: print_summary
+
+Description: Prints the median, 99th percentile, maximum and mean of a set of
+             per-frame values (sorting them in the process).
+
+     Inputs: label      - Name of the measurement.
+             values     - The values.
+             num_values - No. of values.
+             scale      - Divisor converting values to the units printed.
+             units      - Units printed after each value.
+
+    Outputs: None.
+*******************************************************************************/
+void print_summary(const char *const label,
+                   uint64_t *const values,
+                   const size_t num_values,
+                   const double scale,
+                   const char *const units) {
+  size_t i;
+  uint64_t total = 0;
+
+  if (num_values == 0) {
+    return;
+  }
+  qsort(values, num_values, sizeof(uint64_t), compare_values);
+  for (i = 0; i < num_values; ++i) {
+    total += values[i];
+  }
+  printf("  %-10s  p50 %9.1f%s  p99 %9.1f%s  max %9.1f%s  mean %9.1f%s\n",
+         label,
+         PERCENTILE(values, num_values, 50) / scale,
+         units,
+         PERCENTILE(values, num_values, 99) / scale,
+         units,
+         values[num_values - 1] / scale,
+         units,
+         total / scale / num_values,
+         units);
+}
+
+/*******************************************************************************
+   Function: compare_values
+
+Description: Comparison function for sorting values with "qsort".
+
+     Inputs: a - Pointer to one value.
+             b - Pointer to another.
+
+    Outputs: Negative, zero or positive as "a" is less than, equal to or
+             greater than "b".
+*******************************************************************************/
+int compare_values(const void *a, const void *b) {
+  const uint64_t value_a = *(const uint64_t *) a,
+                 value_b = *(const uint64_t *) b;
+
+  return (value_a > value_b) - (value_a < value_b);
+}
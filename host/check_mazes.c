@@ -0,0 +1,413 @@
+/*******************************************************************************
+   Filename: check_mazes.c
+
+     Author: David C. Drake (https://davidcdrake.com)
+
+Description: Consistency checks for MazeCrawler's maze generation, endless
+             mode and saved games, built against the host-side stand-in for
+             the Pebble SDK (see "host/Makefile"):
+
+                 check_mazes <no. of mazes>
+
+             Mazes are generated from seeds 1, 2, 3, etc., with every max.
+             size in turn (see "MAZE_SEED"). Each maze is generated a slice at
+             a time by its timer, as the app does, then again all at once, and
+             both must give the same maze. It must also be perfect: every node
+             (cell at even coordinates) open, exactly 2n - 1 open cells for n
+             nodes (i.e., no loops), every open cell reachable from the
+             entrance and exactly one exit.
+
+             Next, "CHECK_MAZES_ENDLESS_WORLDS" endless labyrinths are started,
+             and the cells around each one's origin must follow the same
+             lattice, be reachable from the origin and come out the same when
+             read again (in reverse order) after every chunk is discarded.
+
+             Finally, every tenth maze is saved and loaded back (via "deinit"
+             and "init"), along with the player, minimap and endless mode, and
+             must come back unchanged, with the baseline's maze key deleted.
+             Stored render engines that are out of range or not built must
+             load as "DEFAULT_RENDER_ENGINE".
+
+             Each failure is printed. Build with "-DWILSON_MAX_STEPS_PER_NODE=1"
+             (see "host/Makefile") to check the backtracker's completion of
+             Wilson's mazes, too.
+*******************************************************************************/
+
+#include "pebble_host.h"
+#define main maze_crawler_main  // The app's "main" is renamed in this build.
+#include "maze_crawler.h"
+#undef main
+
+#define CHECK_MAZES_USAGE          "usage: check_mazes <no. of mazes>\n"
+#define CHECK_MAZES_ENDLESS_WORLDS 10
+#define CHECK_MAZES_SAVE_INTERVAL  10  // Every nth maze is saved and loaded.
+#define ENDLESS_CHECK_RADIUS       4  // Chunks checked on each side of the origin.
+#define ENDLESS_CHECK_SIZE         ((2 * ENDLESS_CHECK_RADIUS + 1) * CHUNK_SIZE)  // Cells per side.
+#define ENDLESS_CHECK_MIN          (-ENDLESS_CHECK_RADIUS * CHUNK_SIZE)  // Lowest coordinate checked.
+#define MAX_MAZE_CELLS_SIZE        (MAZE_ROW_BYTES(MAX_MAZE_WIDTH) * MAX_MAZE_HEIGHT)  // bytes
+
+bool check_maze(const uint32_t seed);
+bool check_perfect_maze(void);
+bool check_endless_world(void);
+bool check_saved_game(const uint32_t seed);
+int count_reachable_cells(const GPoint start,
+                          const GPoint min,
+                          const int16_t width,
+                          const int16_t height);
+
+/*******************************************************************************
+   Function: main
+
+Description: Parses the command line, starts the app and runs every check.
+
+     Inputs: argc - No. of command-line arguments.
+             argv - Command-line arguments (see above).
+
+    Outputs: Exit status (non-zero if the arguments are invalid or any check
+             fails).
+*******************************************************************************/
+int main(int argc, char **argv) {
+  uint32_t seed;
+  int num_mazes, num_failures = 0, i;
+
+  if (argc != 2 || (num_mazes = atoi(argv[1])) < 1) {
+    fprintf(stderr, CHECK_MAZES_USAGE);
+
+    return 1;
+  }
+  init();
+  for (i = 1; i <= num_mazes; ++i) {
+    seed = MAZE_SEED(i, MIN_MAZE_WIDTH +
+                          i % (MAX_MAZE_WIDTH - MIN_MAZE_WIDTH + 1));
+    if (!check_maze(seed)) {
+      num_failures++;
+    }
+  }
+  for (i = 0; i < CHECK_MAZES_ENDLESS_WORLDS; ++i) {
+    if (!check_endless_world()) {
+      num_failures++;
+    }
+  }
+  for (i = CHECK_MAZES_SAVE_INTERVAL; i <= num_mazes;
+       i += CHECK_MAZES_SAVE_INTERVAL) {
+    seed = MAZE_SEED(i, MIN_MAZE_WIDTH +
+                          i % (MAX_MAZE_WIDTH - MIN_MAZE_WIDTH + 1));
+    if (!check_saved_game(seed)) {
+      num_failures++;
+    }
+  }
+  printf("%s: %d maze(s), %d endless world(s), %d saved game(s): %d "
+           "failure(s)\n",
+         HOST_PLATFORM_NAME,
+         num_mazes,
+         CHECK_MAZES_ENDLESS_WORLDS,
+         num_mazes / CHECK_MAZES_SAVE_INTERVAL,
+         num_failures);
+
+  return num_failures > 0;
+}
+
+/*******************************************************************************
+   Function: check_maze
+
+Description: Generates a maze a slice at a time (letting the host's virtual
+             clock run its generation timer), then again all at once, and
+             checks that both are the same perfect maze.
+
+     Inputs: seed - The maze's seed.
+
+    Outputs: Returns "true" if the maze passes.
+*******************************************************************************/
+bool check_maze(const uint32_t seed) {
+  maze_t sliced_maze;
+  uint8_t sliced_cells[MAX_MAZE_CELLS_SIZE];  // (The maze's own are reused.)
+
+  begin_maze_generation(seed);
+  while (g_maze_generation_timer != NULL) {
+    host_advance_time(MAZE_GENERATION_SLICE_INTERVAL);
+  }
+  if (g_maze_generator.stage != GENERATED_STAGE) {
+    printf("seed 0x%08lx: sliced generation didn't finish\n",
+           (unsigned long) seed);
+
+    return false;
+  }
+  init_maze();
+  if (g_maze->cells_size != MAZE_ROW_BYTES(g_maze->width) * g_maze->height) {
+    printf("seed 0x%08lx: %u bytes of cells for %dx%d\n",
+           (unsigned long) seed,
+           (unsigned int) g_maze->cells_size,
+           g_maze->width,
+           g_maze->height);
+
+    return false;
+  }
+  sliced_maze = *g_maze;
+  memcpy(sliced_cells, g_maze->cells, g_maze->cells_size);
+  begin_maze_generation(seed);
+  init_maze();
+  if (sliced_maze.cells_size != g_maze->cells_size ||
+      memcmp(sliced_cells, g_maze->cells, g_maze->cells_size) != 0 ||
+      sliced_maze.width != g_maze->width ||
+      sliced_maze.height != g_maze->height ||
+      !gpoint_equal(&sliced_maze.entrance, &g_maze->entrance) ||
+      sliced_maze.starting_direction != g_maze->starting_direction) {
+    printf("seed 0x%08lx: sliced and whole generation differ\n",
+           (unsigned long) seed);
+
+    return false;
+  }
+  if (!check_perfect_maze()) {
+    printf("seed 0x%08lx (%dx%d): not a perfect maze\n",
+           (unsigned long) seed,
+           g_maze->width,
+           g_maze->height);
+
+    return false;
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: check_perfect_maze
+
+Description: Checks that the current maze is perfect (see above), with its
+             entrance where it says and exactly one exit.
+
+     Inputs: None.
+
+    Outputs: Returns "true" if the maze is perfect.
+*******************************************************************************/
+bool check_perfect_maze(void) {
+  int16_t x, y;
+  int num_nodes = 0, num_open_cells = 0, num_exits = 0;
+  GPoint cell;
+
+  for (x = 0; x < g_maze->width; ++x) {
+    for (y = 0; y < g_maze->height; ++y) {
+      cell = GPoint(x, y);
+      if (x % 2 == 0 && y % 2 == 0) {
+        num_nodes++;
+        if (is_solid(cell)) {
+          return false;
+        }
+      }
+      if (!is_solid(cell)) {
+        num_open_cells++;
+      }
+      if (get_cell_type(cell) == EXIT) {
+        num_exits++;
+      }
+    }
+  }
+
+  return num_open_cells == 2 * num_nodes - 1 &&
+         num_exits == 1 &&
+         get_cell_type(g_maze->entrance) == ENTRANCE &&
+         count_reachable_cells(g_maze->entrance,
+                               GPointZero,
+                               g_maze->width,
+                               g_maze->height) == num_open_cells;
+}
+
+/*******************************************************************************
+   Function: check_endless_world
+
+Description: Starts a new endless labyrinth and checks the cells within
+             "ENDLESS_CHECK_RADIUS" chunks of its origin (see above), then
+             returns to the maze.
+
+     Inputs: None.
+
+    Outputs: Returns "true" if the labyrinth passes.
+*******************************************************************************/
+bool check_endless_world(void) {
+  static int8_t cell_types[ENDLESS_CHECK_SIZE][ENDLESS_CHECK_SIZE];
+  int16_t x, y;
+  int num_open_cells = 0, num_changed_cells = 0;
+  bool passed = true;
+  GPoint cell;
+
+  set_endless_mode(true);
+  for (x = 0; x < ENDLESS_CHECK_SIZE; ++x) {
+    for (y = 0; y < ENDLESS_CHECK_SIZE; ++y) {
+      cell = GPoint(ENDLESS_CHECK_MIN + x, ENDLESS_CHECK_MIN + y);
+      cell_types[x][y] = get_cell_type(cell);
+      if (cell_types[x][y] == EMPTY) {
+        num_open_cells++;
+      } else if (cell_types[x][y] != SOLID) {
+        passed = false;
+      }
+      if ((cell.x % 2 == 0 && cell.y % 2 == 0 && cell_types[x][y] != EMPTY) ||
+          (cell.x % 2 != 0 && cell.y % 2 != 0 && cell_types[x][y] != SOLID)) {
+        passed = false;  // Nodes are always open, and corners always solid.
+      }
+    }
+  }
+  if (!passed) {
+    printf("endless seed 0x%08lx: cells off the lattice\n",
+           (unsigned long) g_endless.seed);
+  }
+  clear_chunks();
+  for (x = ENDLESS_CHECK_SIZE - 1; x >= 0; --x) {
+    for (y = ENDLESS_CHECK_SIZE - 1; y >= 0; --y) {
+      if (get_cell_type(GPoint(ENDLESS_CHECK_MIN + x,
+                               ENDLESS_CHECK_MIN + y)) != cell_types[x][y]) {
+        num_changed_cells++;
+      }
+    }
+  }
+  if (num_changed_cells > 0) {
+    printf("endless seed 0x%08lx: chunks regenerate differently\n",
+           (unsigned long) g_endless.seed);
+    passed = false;
+  }
+  if (count_reachable_cells(GPointZero,
+                            GPoint(ENDLESS_CHECK_MIN, ENDLESS_CHECK_MIN),
+                            ENDLESS_CHECK_SIZE,
+                            ENDLESS_CHECK_SIZE) != num_open_cells) {
+    printf("endless seed 0x%08lx: not every cell reachable\n",
+           (unsigned long) g_endless.seed);
+    passed = false;
+  }
+  set_endless_mode(false);
+
+  return passed;
+}
+
+/*******************************************************************************
+   Function: check_saved_game
+
+Description: Starts a maze, moves the player and marks the minimap, saves the
+             game and loads it back (as when the app exits and is relaunched),
+             and checks that the maze, player, minimap, endless mode and
+             render engine are unchanged and the baseline's maze key deleted.
+             Then loads it again with each invalid render engine stored in
+             turn, which must give the default engine.
+
+     Inputs: seed - The maze's seed.
+
+    Outputs: Returns "true" if the game comes back unchanged.
+*******************************************************************************/
+bool check_saved_game(const uint32_t seed) {
+  maze_t maze;
+  uint8_t cells[MAX_MAZE_CELLS_SIZE];  // (The maze's own are freed.)
+  player_t player;
+  minimap_t minimap;
+  endless_t endless;
+  int8_t render_engine, i;
+  static const int32_t invalid_render_engines[] = {
+    -1,
+    NUM_RENDER_ENGINES,
+    0x100 + RAYCASTING_ENGINE,  // (Valid if truncated to a byte.)
+#ifndef RAYCASTING_ENGINE_ENABLED
+    RAYCASTING_ENGINE,
+#endif
+  };
+
+  begin_maze_generation(seed);
+  init_maze();
+  g_maze->seconds = seed % MAX_SECONDS;
+  g_player->position = GPoint((g_maze->width / 2) & ~1,  // A node.
+                              (g_maze->height / 2) & ~1);
+  g_player->direction = seed % NUM_DIRECTIONS;
+  g_player->points = seed;
+  reveal_minimap_cells(g_player->position);
+#ifdef RAYCASTING_ENGINE_ENABLED
+  g_render_engine = (g_render_engine + 1) % NUM_RENDER_ENGINES;  // Toggled.
+#endif
+  persist_write_data(OLD_MAZE_STORAGE_KEY, "", 1);  // Never read back.
+  maze = *g_maze;
+  memcpy(cells, g_maze->cells, g_maze->cells_size);
+  player = *g_player;
+  minimap = g_minimap;
+  endless = g_endless;
+  render_engine = g_render_engine;
+  while (window_stack_pop(false) != NULL);
+  deinit();
+  memset(&g_minimap, 0, sizeof(g_minimap));
+  memset(&g_endless, 0, sizeof(g_endless));
+  init();
+  if (maze.cells_size != g_maze->cells_size ||
+      memcmp(cells, g_maze->cells, g_maze->cells_size) != 0 ||
+      maze.width != g_maze->width ||
+      maze.height != g_maze->height ||
+      maze.seed != g_maze->seed ||
+      maze.seconds != g_maze->seconds ||
+      memcmp(&player, g_player, sizeof(player_t)) != 0 ||
+      memcmp(&minimap, &g_minimap, sizeof(minimap_t)) != 0 ||
+      memcmp(&endless, &g_endless, sizeof(endless_t)) != 0 ||
+      render_engine != g_render_engine) {
+    printf("seed 0x%08lx: saved game loads back differently\n",
+           (unsigned long) seed);
+
+    return false;
+  }
+  if (persist_exists(OLD_MAZE_STORAGE_KEY)) {
+    printf("seed 0x%08lx: baseline maze key not deleted\n",
+           (unsigned long) seed);
+
+    return false;
+  }
+  for (i = 0;
+       i < (int8_t) (sizeof(invalid_render_engines) / sizeof(int32_t));
+       ++i) {
+    while (window_stack_pop(false) != NULL);
+    deinit();
+    persist_write_int(RENDER_ENGINE_STORAGE_KEY, invalid_render_engines[i]);
+    init();
+    if (g_render_engine != DEFAULT_RENDER_ENGINE) {
+      printf("seed 0x%08lx: stored render engine %ld not replaced\n",
+             (unsigned long) seed,
+             (long) invalid_render_engines[i]);
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: count_reachable_cells
+
+Description: Counts the open cells within a rectangle that can be reached from
+             a given cell without leaving it (by a breadth-first search).
+
+     Inputs: start  - The starting cell (which must be open).
+             min    - The rectangle's top-left cell.
+             width  - The rectangle's width, in cells.
+             height - The rectangle's height, in cells.
+
+    Outputs: The no. of reachable cells, including "start".
+*******************************************************************************/
+int count_reachable_cells(const GPoint start,
+                          const GPoint min,
+                          const int16_t width,
+                          const int16_t height) {
+  static bool reached[ENDLESS_CHECK_SIZE][ENDLESS_CHECK_SIZE];  // (> a maze.)
+  static GPoint queue[ENDLESS_CHECK_SIZE * ENDLESS_CHECK_SIZE];
+  int head = 0, tail = 0;
+  int8_t direction;
+  GPoint cell;
+
+  memset(reached, 0, sizeof(reached));
+  reached[start.x - min.x][start.y - min.y] = true;
+  queue[tail++] = start;
+  while (head < tail) {
+    for (direction = 0; direction < NUM_DIRECTIONS; ++direction) {
+      cell = get_cell_farther_away(queue[head], direction, 1);
+      if (cell.x >= min.x && cell.x < min.x + width &&
+          cell.y >= min.y && cell.y < min.y + height &&
+          !reached[cell.x - min.x][cell.y - min.y] &&
+          !is_solid(cell)) {
+        reached[cell.x - min.x][cell.y - min.y] = true;
+        queue[tail++] = cell;
+      }
+    }
+    head++;
+  }
+
+  return tail;
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+"""
+   Filename: generate_resource_ids.py
+
+Description: Generator for "resource_ids.auto.h" in the host build, standing in
+             for the header the Pebble SDK generates from "appinfo.json". Each
+             media entry gets a "RESOURCE_ID_" constant (numbered from 1, in
+             order) and its file is listed in "HOST_RESOURCE_FILES", relative
+             to the resources directory. As with the SDK, a file tagged with
+             the platform's name (e.g., "wall_texture_brick~chalk.bin") is
+             used in place of the untagged one if it exists:
+
+                 generate_resource_ids.py <appinfo.json> \\
+                                          <resources directory> <platform>
+
+             (The header is written to standard output.)
+"""
+
+import json
+import os
+import sys
+
+
+def get_platform_file(resources_dir, path, platform):
+    """Returns the platform-tagged version of a resource file, if there is
+    one, or else the file itself."""
+    root, extension = os.path.splitext(path)
+    tagged_path = '%s~%s%s' % (root, platform, extension)
+    if os.path.exists(os.path.join(resources_dir, tagged_path)):
+        return tagged_path
+
+    return path
+
+
+def main():
+    with open(sys.argv[1]) as f:
+        media = json.load(f)['resources']['media']
+    out = []
+
+    out.append('/* Generated by host/generate_resource_ids.py. Do not edit. */')
+    out.append('#ifndef RESOURCE_IDS_AUTO_H_')
+    out.append('#define RESOURCE_IDS_AUTO_H_')
+    out.append('')
+    for i, entry in enumerate(media):
+        out.append('#define RESOURCE_ID_%s %d' % (entry['name'], i + 1))
+    out.append('')
+    out.append('#define HOST_RESOURCE_FILES { \\')
+    out.append('  NULL, \\')
+    for entry in media:
+        out.append('  "%s", \\' % get_platform_file(sys.argv[2], entry['file'],
+                                                   sys.argv[3]))
+    out.append('}')
+    out.append('')
+    out.append('#endif  // RESOURCE_IDS_AUTO_H_')
+    sys.stdout.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,358 @@
+/*******************************************************************************
+   Filename: pebble.h
+
+     Author: David C. Drake (https://davidcdrake.com)
+
+Description: Host-side stand-in for the subset of the Pebble SDK's "pebble.h"
+             that MazeCrawler uses, so "src/maze_crawler.c" can be compiled
+             unchanged for an ordinary computer (see "host/Makefile"). Opaque
+             SDK types are defined in "pebble_host.h".
+*******************************************************************************/
+
+#ifndef PEBBLE_H_
+#define PEBBLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "resource_ids.auto.h"
+
+#if !defined(PBL_COLOR) && !defined(PBL_BW)
+#define PBL_COLOR
+#endif
+#if !defined(PBL_RECT) && !defined(PBL_ROUND)
+#define PBL_RECT
+#endif
+
+#if defined(PBL_PLATFORM_CHALK)
+#define PBL_DISPLAY_WIDTH  180
+#define PBL_DISPLAY_HEIGHT 180
+#elif defined(PBL_PLATFORM_EMERY)
+#define PBL_DISPLAY_WIDTH  200
+#define PBL_DISPLAY_HEIGHT 228
+#else
+#define PBL_DISPLAY_WIDTH  144
+#define PBL_DISPLAY_HEIGHT 168
+#endif
+
+#ifdef PBL_ROUND
+#define PBL_IF_ROUND_ELSE(a, b) (a)
+#else
+#define PBL_IF_ROUND_ELSE(a, b) (b)
+#endif
+#ifdef PBL_COLOR
+#define PBL_IF_COLOR_ELSE(a, b) (a)
+#else
+#define PBL_IF_COLOR_ELSE(a, b) (b)
+#endif
+
+typedef struct GPoint { int16_t x; int16_t y; } GPoint;
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GPointZero GPoint(0, 0)
+typedef struct GSize { int16_t w; int16_t h; } GSize;
+#define GSize(w, h) ((GSize){(w), (h)})
+typedef struct GRect { GPoint origin; GSize size; } GRect;
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GRectZero GRect(0, 0, 0, 0)
+
+bool gpoint_equal(const GPoint *const a, const GPoint *const b);
+
+typedef union GColor8 {
+  uint8_t argb;
+  struct { uint8_t b:2; uint8_t g:2; uint8_t r:2; uint8_t a:2; };
+} GColor8;
+typedef GColor8 GColor;
+#define GColorFromARGB8(v) ((GColor8){.argb = (v)})
+#define GColorClear                 GColorFromARGB8(0x00)
+#define GColorBlack                 GColorFromARGB8(0xC0)
+#define GColorOxfordBlue            GColorFromARGB8(0xC1)
+#define GColorDukeBlue              GColorFromARGB8(0xC2)
+#define GColorBlue                  GColorFromARGB8(0xC3)
+#define GColorDarkGreen             GColorFromARGB8(0xC4)
+#define GColorMidnightGreen         GColorFromARGB8(0xC5)
+#define GColorCobaltBlue            GColorFromARGB8(0xC6)
+#define GColorBlueMoon              GColorFromARGB8(0xC7)
+#define GColorIslamicGreen          GColorFromARGB8(0xC8)
+#define GColorJaegerGreen           GColorFromARGB8(0xC9)
+#define GColorTiffanyBlue           GColorFromARGB8(0xCA)
+#define GColorVividCerulean         GColorFromARGB8(0xCB)
+#define GColorGreen                 GColorFromARGB8(0xCC)
+#define GColorMalachite             GColorFromARGB8(0xCD)
+#define GColorMediumSpringGreen     GColorFromARGB8(0xCE)
+#define GColorCyan                  GColorFromARGB8(0xCF)
+#define GColorBulgarianRose         GColorFromARGB8(0xD0)
+#define GColorImperialPurple        GColorFromARGB8(0xD1)
+#define GColorIndigo                GColorFromARGB8(0xD2)
+#define GColorElectricUltramarine   GColorFromARGB8(0xD3)
+#define GColorArmyGreen             GColorFromARGB8(0xD4)
+#define GColorDarkGray              GColorFromARGB8(0xD5)
+#define GColorLiberty               GColorFromARGB8(0xD6)
+#define GColorVeryLightBlue         GColorFromARGB8(0xD7)
+#define GColorKellyGreen            GColorFromARGB8(0xD8)
+#define GColorMayGreen              GColorFromARGB8(0xD9)
+#define GColorCadetBlue             GColorFromARGB8(0xDA)
+#define GColorPictonBlue            GColorFromARGB8(0xDB)
+#define GColorBrightGreen           GColorFromARGB8(0xDC)
+#define GColorScreaminGreen         GColorFromARGB8(0xDD)
+#define GColorMediumAquamarine      GColorFromARGB8(0xDE)
+#define GColorElectricBlue          GColorFromARGB8(0xDF)
+#define GColorDarkCandyAppleRed     GColorFromARGB8(0xE0)
+#define GColorJazzberryJam          GColorFromARGB8(0xE1)
+#define GColorPurple                GColorFromARGB8(0xE2)
+#define GColorVividViolet           GColorFromARGB8(0xE3)
+#define GColorWindsorTan            GColorFromARGB8(0xE4)
+#define GColorRoseVale              GColorFromARGB8(0xE5)
+#define GColorPurpureus             GColorFromARGB8(0xE6)
+#define GColorLavenderIndigo        GColorFromARGB8(0xE7)
+#define GColorLimerick              GColorFromARGB8(0xE8)
+#define GColorBrass                 GColorFromARGB8(0xE9)
+#define GColorLightGray             GColorFromARGB8(0xEA)
+#define GColorBabyBlueEyes          GColorFromARGB8(0xEB)
+#define GColorSpringBud             GColorFromARGB8(0xEC)
+#define GColorInchworm              GColorFromARGB8(0xED)
+#define GColorMintGreen             GColorFromARGB8(0xEE)
+#define GColorCeleste               GColorFromARGB8(0xEF)
+#define GColorRed                   GColorFromARGB8(0xF0)
+#define GColorFolly                 GColorFromARGB8(0xF1)
+#define GColorFashionMagenta        GColorFromARGB8(0xF2)
+#define GColorMagenta               GColorFromARGB8(0xF3)
+#define GColorOrange                GColorFromARGB8(0xF4)
+#define GColorSunsetOrange          GColorFromARGB8(0xF5)
+#define GColorBrilliantRose         GColorFromARGB8(0xF6)
+#define GColorShockingPink          GColorFromARGB8(0xF7)
+#define GColorChromeYellow          GColorFromARGB8(0xF8)
+#define GColorRajah                 GColorFromARGB8(0xF9)
+#define GColorMelon                 GColorFromARGB8(0xFA)
+#define GColorRichBrilliantLavender GColorFromARGB8(0xFB)
+#define GColorYellow                GColorFromARGB8(0xFC)
+#define GColorIcterine              GColorFromARGB8(0xFD)
+#define GColorPastelYellow          GColorFromARGB8(0xFE)
+#define GColorWhite                 GColorFromARGB8(0xFF)
+bool gcolor_equal(GColor8 x, GColor8 y);
+
+typedef enum {
+  GBitmapFormat1Bit = 0,
+  GBitmapFormat8Bit,
+  GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette,
+  GBitmapFormat4BitPalette,
+  GBitmapFormat8BitCircular,
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+typedef struct GBitmapDataRowInfo {
+  uint8_t *data;
+  int16_t min_x;
+  int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap,
+                                             uint16_t y);
+
+typedef enum { GCornerNone = 0, GCornersAll = 0xf } GCornerMask;
+typedef enum { GCompOpAssign, GCompOpAssignInverted, GCompOpOr, GCompOpAnd,
+               GCompOpClear, GCompOpSet } GCompOp;
+
+typedef struct GContext GContext;
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_context_set_antialiased(GContext *ctx, bool enable);
+void graphics_draw_pixel(GContext *ctx, GPoint point);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_draw_rect(GContext *ctx, GRect rect);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius,
+                        GCornerMask corner_mask);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap,
+                                  GRect rect);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+typedef struct GPathInfo { uint32_t num_points; GPoint *points; } GPathInfo;
+typedef struct GPath GPath;
+GPath *gpath_create(const GPathInfo *init);
+void gpath_destroy(GPath *path);
+void gpath_rotate_to(GPath *path, int32_t angle);
+void gpath_move_to(GPath *path, GPoint point);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void gpath_draw_outline(GContext *ctx, GPath *path);
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+typedef struct Layer Layer;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void layer_destroy(Layer *layer);
+void *layer_get_data(const Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+
+typedef struct Window Window;
+typedef void (*WindowHandler)(Window *window);
+typedef struct WindowHandlers {
+  WindowHandler load, appear, disappear, unload;
+} WindowHandlers;
+typedef void (*ClickConfigProvider)(void *context);
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef enum { BUTTON_ID_BACK, BUTTON_ID_UP, BUTTON_ID_SELECT,
+               BUTTON_ID_DOWN, NUM_BUTTONS } ButtonId;
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_background_color(Window *window, GColor color);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_click_config_provider(Window *window,
+                                      ClickConfigProvider provider);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+Window *window_stack_pop(bool animated);
+bool window_stack_contains_window(Window *window);
+Window *window_stack_get_top_window(void);
+void window_single_click_subscribe(ButtonId id, ClickHandler handler);
+void window_single_repeating_click_subscribe(ButtonId id,
+                                             uint16_t repeat_interval_ms,
+                                             ClickHandler handler);
+void window_multi_click_subscribe(ButtonId id, uint8_t min_clicks,
+                                  uint8_t max_clicks, uint16_t timeout,
+                                  bool last_click_only, ClickHandler handler);
+void window_long_click_subscribe(ButtonId id, uint16_t delay_ms,
+                                 ClickHandler down_handler,
+                                 ClickHandler up_handler);
+void light_enable_interaction(void);
+
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter,
+               GTextAlignmentRight } GTextAlignment;
+typedef void *GFont;
+#define FONT_KEY_GOTHIC_14 "GOTHIC_14"
+#define FONT_KEY_GOTHIC_24_BOLD "GOTHIC_24_BOLD"
+GFont fonts_get_system_font(const char *font_key);
+typedef struct TextLayer TextLayer;
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+const char *text_layer_get_text(TextLayer *text_layer);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer *text_layer,
+                                   GTextAlignment alignment);
+
+typedef struct StatusBarLayer StatusBarLayer;
+StatusBarLayer *status_bar_layer_create(void);
+void status_bar_layer_destroy(StatusBarLayer *status_bar_layer);
+Layer *status_bar_layer_get_layer(StatusBarLayer *status_bar_layer);
+
+typedef struct ScrollLayer ScrollLayer;
+
+typedef struct MenuIndex { uint16_t section; uint16_t row; } MenuIndex;
+typedef enum { MenuRowAlignNone, MenuRowAlignCenter, MenuRowAlignTop,
+               MenuRowAlignBottom } MenuRowAlign;
+typedef struct MenuLayer MenuLayer;
+typedef uint16_t (*MenuLayerGetNumberOfRowsInSectionsCallback)(
+  MenuLayer *menu_layer, uint16_t section_index, void *callback_context);
+typedef void (*MenuLayerDrawRowCallback)(GContext *ctx,
+                                         const Layer *cell_layer,
+                                         MenuIndex *cell_index,
+                                         void *callback_context);
+typedef void (*MenuLayerSelectCallback)(MenuLayer *menu_layer,
+                                        MenuIndex *cell_index,
+                                        void *callback_context);
+typedef struct MenuLayerCallbacks {
+  MenuLayerGetNumberOfRowsInSectionsCallback get_num_rows;
+  MenuLayerDrawRowCallback draw_row;
+  MenuLayerSelectCallback select_click;
+} MenuLayerCallbacks;
+MenuLayer *menu_layer_create(GRect frame);
+void menu_layer_destroy(MenuLayer *menu_layer);
+Layer *menu_layer_get_layer(const MenuLayer *menu_layer);
+void menu_layer_set_callbacks(MenuLayer *menu_layer, void *callback_context,
+                              MenuLayerCallbacks callbacks);
+void menu_layer_set_click_config_onto_window(MenuLayer *menu_layer,
+                                             Window *window);
+void menu_layer_set_selected_index(MenuLayer *menu_layer, MenuIndex index,
+                                   MenuRowAlign scroll_align, bool animated);
+void menu_layer_reload_data(MenuLayer *menu_layer);
+void menu_cell_basic_draw(GContext *ctx, const Layer *cell_layer,
+                          const char *title, const char *subtitle,
+                          GBitmap *icon);
+
+typedef enum { SECOND_UNIT = 1 << 0, MINUTE_UNIT = 1 << 1 } TimeUnits;
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+typedef void (*AppFocusHandler)(bool in_focus);
+void app_focus_service_subscribe(AppFocusHandler handler);
+void app_focus_service_unsubscribe(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback,
+                             void *callback_data);
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer);
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+
+#define PERSIST_DATA_MAX_LENGTH 256
+bool persist_exists(uint32_t key);
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+int32_t persist_read_int(uint32_t key);
+int persist_write_int(uint32_t key, int32_t value);
+int persist_delete(uint32_t key);
+
+size_t heap_bytes_free(void);
+size_t heap_bytes_used(void);
+
+// The app's heap, which is counted (see "heap_bytes_used") and as small as the
+// watch's. The app's own allocations are routed here when built with
+// "HOST_APP" (see "host/Makefile"), as are the SDK objects it creates.
+void *host_malloc(size_t size);
+void *host_calloc(size_t count, size_t size);
+void host_free(void *ptr);
+#ifdef HOST_APP
+#define malloc host_malloc
+#define calloc host_calloc
+#define free   host_free
+#endif
+
+typedef struct ResHandle_ *ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle handle);
+size_t resource_load(ResHandle handle, uint8_t *buffer, size_t max_length);
+size_t resource_load_byte_range(ResHandle handle, uint32_t start_offset,
+                                uint8_t *buffer, size_t num_bytes);
+
+typedef enum { APP_LOG_LEVEL_ERROR = 1, APP_LOG_LEVEL_WARNING = 50,
+               APP_LOG_LEVEL_INFO = 100, APP_LOG_LEVEL_DEBUG = 200,
+               APP_LOG_LEVEL_DEBUG_VERBOSE = 255 } AppLogLevel;
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number,
+             const char *fmt, ...);
+#define APP_LOG(level, fmt, ...) \
+  app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+void app_event_loop(void);
+
+#endif  // PEBBLE_H_
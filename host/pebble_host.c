@@ -0,0 +1,1345 @@
+/*******************************************************************************
+   Filename: pebble_host.c
+
+     Author: David C. Drake (https://davidcdrake.com)
+
+Description: Function definitions for the host-side stand-in for the Pebble
+             SDK. SDK functions behave just closely enough to their on-watch
+             counterparts for MazeCrawler's purposes; the "host_" functions let
+             a driver program render frames, press buttons, advance time and
+             inspect the results.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdarg.h>
+
+#include "pebble_host.h"
+
+/*******************************************************************************
+  Geometry and Colors
+*******************************************************************************/
+
+bool gpoint_equal(const GPoint *const a, const GPoint *const b) {
+  return a->x == b->x && a->y == b->y;
+}
+
+bool gcolor_equal(GColor8 x, GColor8 y) {
+  return x.argb == y.argb;
+}
+
+/*******************************************************************************
+  Bitmaps
+*******************************************************************************/
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = host_calloc(1, sizeof(GBitmap));
+
+  bitmap->format = format;
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  if (format == GBitmapFormat1Bit) {
+    bitmap->row_size_bytes = ((size.w + 31) / 32) * 4;
+  } else {
+    bitmap->row_size_bytes = size.w;
+  }
+  bitmap->data = host_calloc(bitmap->row_size_bytes, size.h);
+
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap != NULL) {
+    host_free(bitmap->data);
+    host_free(bitmap);
+  }
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->format == GBitmapFormat8BitCircular ?
+           0 : bitmap->row_size_bytes;  // (Rows vary in length when round.)
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+  return bitmap->format;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap,
+                                             uint16_t y) {
+  GBitmapDataRowInfo info;
+  int16_t inset = 0;
+
+  if (bitmap == g_host_screen && g_host_screen_insets != NULL) {
+    inset = g_host_screen_insets[y];  // (Precomputed, as it's used per pixel.)
+  } else if (bitmap->format == GBitmapFormat8BitCircular) {
+    inset = host_get_circular_inset(y,
+                                    bitmap->bounds.size.w,
+                                    bitmap->bounds.size.h);
+  }
+  info.data = bitmap->data + y * bitmap->row_size_bytes;
+  info.min_x = inset;
+  info.max_x = bitmap->bounds.size.w - 1 - inset;
+
+  return info;
+}
+
+/*******************************************************************************
+  Graphics Context
+*******************************************************************************/
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+  g_host_stats.stroke_color_calls++;
+  ctx->stroke_color = color;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  g_host_stats.fill_color_calls++;
+  ctx->fill_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {}
+
+void graphics_context_set_antialiased(GContext *ctx, bool enable) {}
+
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+  g_host_stats.pixel_calls++;
+  host_plot(ctx, point.x, point.y, ctx->stroke_color);
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  int16_t x = p0.x, y = p0.y, step_x, step_y, dx, dy, error, doubled_error;
+
+  g_host_stats.line_calls++;
+  dx = abs(p1.x - p0.x);
+  dy = -abs(p1.y - p0.y);
+  step_x = p0.x < p1.x ? 1 : -1;
+  step_y = p0.y < p1.y ? 1 : -1;
+  error = dx + dy;
+  for (;;) {  // Bresenham's algorithm.
+    host_plot(ctx, x, y, ctx->stroke_color);
+    if (x == p1.x && y == p1.y) {
+      break;
+    }
+    doubled_error = 2 * error;
+    if (doubled_error >= dy) {
+      error += dy;
+      x += step_x;
+    }
+    if (doubled_error <= dx) {
+      error += dx;
+      y += step_y;
+    }
+  }
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+  int16_t x, y;
+
+  g_host_stats.rect_calls++;
+  for (x = rect.origin.x; x < rect.origin.x + rect.size.w; ++x) {
+    host_plot(ctx, x, rect.origin.y, ctx->stroke_color);
+    host_plot(ctx, x, rect.origin.y + rect.size.h - 1, ctx->stroke_color);
+  }
+  for (y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+    host_plot(ctx, rect.origin.x, y, ctx->stroke_color);
+    host_plot(ctx, rect.origin.x + rect.size.w - 1, y, ctx->stroke_color);
+  }
+}
+
+void graphics_fill_rect(GContext *ctx,
+                        GRect rect,
+                        uint16_t corner_radius,
+                        GCornerMask corner_mask) {
+  int16_t x, y;
+
+  g_host_stats.rect_calls++;
+  for (y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+    for (x = rect.origin.x; x < rect.origin.x + rect.size.w; ++x) {
+      host_plot(ctx, x, y, ctx->fill_color);
+    }
+  }
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  int16_t x, y;
+
+  g_host_stats.circle_calls++;
+  for (y = -radius; y <= radius; ++y) {
+    for (x = -radius; x <= radius; ++x) {
+      if (x * x + y * y <= radius * radius) {
+        host_plot(ctx, p.x + x, p.y + y, ctx->fill_color);
+      }
+    }
+  }
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx,
+                                  const GBitmap *bitmap,
+                                  GRect rect) {
+  int16_t x, y;
+  GColor color;
+
+  g_host_stats.bitmap_calls++;
+  for (y = 0; y < rect.size.h && y < bitmap->bounds.size.h; ++y) {
+    for (x = 0; x < rect.size.w && x < bitmap->bounds.size.w; ++x) {
+      if (bitmap->format == GBitmapFormat1Bit) {
+        color = host_read_bitmap_bit(bitmap, x, y) ? GColorWhite : GColorBlack;
+      } else {
+        color.argb = bitmap->data[y * bitmap->row_size_bytes + x];
+      }
+      host_plot(ctx, rect.origin.x + x, rect.origin.y + y, color);
+    }
+  }
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  if (ctx->frame_buffer_captured) {
+    return NULL;
+  }
+  g_host_stats.capture_calls++;
+  ctx->frame_buffer_captured = true;
+  host_begin_capture();
+
+  return ctx->frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  if (!ctx->frame_buffer_captured || buffer != ctx->frame_buffer) {
+    return false;
+  }
+  host_end_capture();
+  ctx->frame_buffer_captured = false;
+
+  return true;
+}
+
+/*******************************************************************************
+  Paths and Trigonometry
+*******************************************************************************/
+
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t) lround(sin(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) *
+                          TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t) lround(cos(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) *
+                          TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+  double angle = atan2(y, x);
+
+  if (angle < 0) {
+    angle += 2.0 * M_PI;
+  }
+
+  return (int32_t) (angle * TRIG_MAX_ANGLE / (2.0 * M_PI));
+}
+
+GPath *gpath_create(const GPathInfo *init) {
+  GPath *path = host_calloc(1, sizeof(GPath));
+
+  path->num_points = init->num_points;
+  path->points = init->points;
+
+  return path;
+}
+
+void gpath_destroy(GPath *path) {
+  host_free(path);
+}
+
+void gpath_rotate_to(GPath *path, int32_t angle) {
+  path->rotation = angle;
+}
+
+void gpath_move_to(GPath *path, GPoint point) {
+  path->offset = point;
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+  int16_t x, y;
+  uint32_t i, j;
+  bool inside;
+  GPoint a, b;
+
+  // Test each point near the path's origin (paths are small) by ray casting:
+  g_host_stats.path_calls++;
+  for (y = path->offset.y - 8; y <= path->offset.y + 8; ++y) {
+    for (x = path->offset.x - 8; x <= path->offset.x + 8; ++x) {
+      inside = false;
+      for (i = 0, j = path->num_points - 1; i < path->num_points; j = i++) {
+        a = host_get_path_point(path, i);
+        b = host_get_path_point(path, j);
+        if ((a.y > y) != (b.y > y) &&
+            x < (b.x - a.x) * (y - a.y) / (double) (b.y - a.y) + a.x) {
+          inside = !inside;
+        }
+      }
+      if (inside) {
+        host_plot(ctx, x, y, ctx->fill_color);
+      }
+    }
+  }
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+  uint32_t i;
+
+  g_host_stats.path_calls++;
+  for (i = 0; i + 1 < path->num_points; ++i) {
+    graphics_draw_line(ctx,
+                       host_get_path_point(path, i),
+                       host_get_path_point(path, i + 1));
+  }
+}
+
+/*******************************************************************************
+  Layers
+*******************************************************************************/
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = host_calloc(1, sizeof(Layer));
+
+  layer->frame = frame;
+
+  return layer;
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+  Layer *layer = layer_create(frame);
+
+  layer->data = host_calloc(1, data_size);
+
+  return layer;
+}
+
+void layer_destroy(Layer *layer) {
+  if (layer != NULL) {
+    host_free(layer->data);
+    host_free(layer);
+  }
+}
+
+void *layer_get_data(const Layer *layer) {
+  return layer->data;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  g_host_stats.dirty_marks++;  // Drivers decide when to "host_render".
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  if (parent->num_children < HOST_MAX_CHILD_LAYERS) {
+    parent->children[parent->num_children++] = child;
+    child->parent = parent;
+  }
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  layer->hidden = hidden;
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+  return (GFont) font_key;
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = host_calloc(1, sizeof(TextLayer));
+
+  text_layer->layer.frame = frame;
+  text_layer->layer.filled = true;
+  text_layer->layer.background_color = GColorWhite;
+
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  host_free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  g_host_stats.text_updates++;
+  text_layer->text = text;
+}
+
+const char *text_layer_get_text(TextLayer *text_layer) {
+  return text_layer->text;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  text_layer->layer.background_color = color;
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {}
+
+void text_layer_set_text_alignment(TextLayer *text_layer,
+                                   GTextAlignment alignment) {}
+
+StatusBarLayer *status_bar_layer_create(void) {
+  StatusBarLayer *status_bar_layer = host_calloc(1, sizeof(StatusBarLayer));
+
+  status_bar_layer->layer.frame = GRect(0,
+                                        0,
+                                        PBL_DISPLAY_WIDTH,
+                                        HOST_STATUS_BAR_HEIGHT);
+  status_bar_layer->layer.filled = true;
+  status_bar_layer->layer.background_color = GColorBlack;
+
+  return status_bar_layer;
+}
+
+void status_bar_layer_destroy(StatusBarLayer *status_bar_layer) {
+  host_free(status_bar_layer);
+}
+
+Layer *status_bar_layer_get_layer(StatusBarLayer *status_bar_layer) {
+  return &status_bar_layer->layer;
+}
+
+MenuLayer *menu_layer_create(GRect frame) {
+  MenuLayer *menu_layer = host_calloc(1, sizeof(MenuLayer));
+
+  menu_layer->layer.frame = frame;
+
+  return menu_layer;
+}
+
+void menu_layer_destroy(MenuLayer *menu_layer) {
+  host_free(menu_layer);
+}
+
+Layer *menu_layer_get_layer(const MenuLayer *menu_layer) {
+  return (Layer *) &menu_layer->layer;
+}
+
+void menu_layer_set_callbacks(MenuLayer *menu_layer,
+                              void *callback_context,
+                              MenuLayerCallbacks callbacks) {}
+
+void menu_layer_set_click_config_onto_window(MenuLayer *menu_layer,
+                                             Window *window) {}
+
+void menu_layer_set_selected_index(MenuLayer *menu_layer,
+                                   MenuIndex index,
+                                   MenuRowAlign scroll_align,
+                                   bool animated) {}
+
+void menu_layer_reload_data(MenuLayer *menu_layer) {}
+
+void menu_cell_basic_draw(GContext *ctx,
+                          const Layer *cell_layer,
+                          const char *title,
+                          const char *subtitle,
+                          GBitmap *icon) {}
+
+/*******************************************************************************
+  Windows and Clicks
+*******************************************************************************/
+
+Window *window_create(void) {
+  Window *window = host_calloc(1, sizeof(Window));
+
+  window->root_layer = layer_create(GRect(0,
+                                          0,
+                                          PBL_DISPLAY_WIDTH,
+                                          PBL_DISPLAY_HEIGHT));
+  window->background_color = GColorWhite;
+
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (window != NULL) {
+    layer_destroy(window->root_layer);
+    host_free(window);
+  }
+}
+
+void window_set_background_color(Window *window, GColor color) {
+  window->background_color = color;
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_set_click_config_provider(Window *window,
+                                      ClickConfigProvider provider) {
+  window->click_config_provider = provider;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return window->root_layer;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  Window *top_window = window_stack_get_top_window();
+
+  if (top_window != NULL && top_window->handlers.disappear != NULL) {
+    top_window->handlers.disappear(top_window);
+  }
+  g_host_window_stack[g_host_window_stack_size++] = window;
+  memset(g_host_click_handlers, 0, sizeof(g_host_click_handlers));
+  if (window->click_config_provider != NULL) {
+    window->click_config_provider(window);
+  }
+  if (window->handlers.appear != NULL) {
+    window->handlers.appear(window);
+  }
+}
+
+Window *window_stack_pop(bool animated) {
+  Window *window, *top_window;
+
+  if (g_host_window_stack_size == 0) {
+    return NULL;
+  }
+  window = g_host_window_stack[--g_host_window_stack_size];
+  if (window->handlers.disappear != NULL) {
+    window->handlers.disappear(window);
+  }
+  top_window = window_stack_get_top_window();
+  if (top_window != NULL) {
+    memset(g_host_click_handlers, 0, sizeof(g_host_click_handlers));
+    if (top_window->click_config_provider != NULL) {
+      top_window->click_config_provider(top_window);
+    }
+    if (top_window->handlers.appear != NULL) {
+      top_window->handlers.appear(top_window);
+    }
+  }
+
+  return window;
+}
+
+bool window_stack_contains_window(Window *window) {
+  int8_t i;
+
+  for (i = 0; i < g_host_window_stack_size; ++i) {
+    if (g_host_window_stack[i] == window) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+Window *window_stack_get_top_window(void) {
+  return g_host_window_stack_size == 0 ?
+           NULL : g_host_window_stack[g_host_window_stack_size - 1];
+}
+
+void window_single_click_subscribe(ButtonId id, ClickHandler handler) {
+  g_host_click_handlers[id][SINGLE_CLICK] = handler;
+}
+
+void window_single_repeating_click_subscribe(ButtonId id,
+                                             uint16_t repeat_interval_ms,
+                                             ClickHandler handler) {
+  g_host_click_handlers[id][SINGLE_CLICK] = handler;
+}
+
+void window_multi_click_subscribe(ButtonId id,
+                                  uint8_t min_clicks,
+                                  uint8_t max_clicks,
+                                  uint16_t timeout,
+                                  bool last_click_only,
+                                  ClickHandler handler) {
+  g_host_click_handlers[id][MULTI_CLICK] = handler;
+}
+
+void window_long_click_subscribe(ButtonId id,
+                                 uint16_t delay_ms,
+                                 ClickHandler down_handler,
+                                 ClickHandler up_handler) {
+  g_host_click_handlers[id][LONG_CLICK] = down_handler;
+}
+
+void light_enable_interaction(void) {}
+
+/*******************************************************************************
+  Services and Timers
+*******************************************************************************/
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  g_host_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  g_host_tick_handler = NULL;
+}
+
+void app_focus_service_subscribe(AppFocusHandler handler) {
+  g_host_focus_handler = handler;
+}
+
+void app_focus_service_unsubscribe(void) {
+  g_host_focus_handler = NULL;
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms,
+                             AppTimerCallback callback,
+                             void *callback_data) {
+  int8_t i;
+
+  for (i = 0; i < HOST_MAX_TIMERS; ++i) {
+    if (!g_host_timers[i].active) {
+      g_host_timers[i].active = true;
+      g_host_timers[i].due_time = g_host_virtual_time + timeout_ms;
+      g_host_timers[i].callback = callback;
+      g_host_timers[i].data = callback_data;
+
+      return &g_host_timers[i];
+    }
+  }
+
+  return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+  if (timer == NULL || !timer->active) {
+    return false;
+  }
+  timer->due_time = g_host_virtual_time + new_timeout_ms;
+
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+  if (timer != NULL) {
+    timer->active = false;
+  }
+}
+
+// Time only passes via "host_advance_time", so renders are repeatable:
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  if (tloc != NULL) {
+    *tloc = (time_t) (g_host_virtual_time / 1000);
+  }
+  if (out_ms != NULL) {
+    *out_ms = g_host_virtual_time % 1000;
+  }
+
+  return g_host_virtual_time % 1000;
+}
+
+/*******************************************************************************
+  Persistent Storage
+*******************************************************************************/
+
+bool persist_exists(uint32_t key) {
+  return host_find_persistent_value(key) >= 0;
+}
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size) {
+  int8_t i = host_find_persistent_value(key);
+
+  if (i < 0) {
+    return -1;
+  }
+  if (buffer_size > g_host_persistent_values[i].size) {
+    buffer_size = g_host_persistent_values[i].size;
+  }
+  memcpy(buffer, g_host_persistent_values[i].data, buffer_size);
+
+  return buffer_size;
+}
+
+int persist_write_data(uint32_t key, const void *data, size_t size) {
+  int8_t i = host_find_persistent_value(key);
+
+  g_host_stats.persist_writes++;
+  if (size > PERSIST_DATA_MAX_LENGTH) {
+    size = PERSIST_DATA_MAX_LENGTH;
+  }
+  for (i = i < 0 ? 0 : i;
+       i < HOST_MAX_PERSIST_KEYS &&
+         g_host_persistent_values[i].used &&
+         g_host_persistent_values[i].key != key;
+       ++i) {}
+  if (i == HOST_MAX_PERSIST_KEYS) {
+    return -1;
+  }
+  g_host_persistent_values[i].used = true;
+  g_host_persistent_values[i].key = key;
+  g_host_persistent_values[i].size = size;
+  memcpy(g_host_persistent_values[i].data, data, size);
+
+  return size;
+}
+
+int32_t persist_read_int(uint32_t key) {
+  int32_t value = 0;
+
+  persist_read_data(key, &value, sizeof(value));
+
+  return value;
+}
+
+int persist_write_int(uint32_t key, int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_delete(uint32_t key) {
+  int8_t i = host_find_persistent_value(key);
+
+  if (i >= 0) {
+    g_host_persistent_values[i].used = false;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+  Memory, Resources and Logging
+*******************************************************************************/
+
+size_t heap_bytes_free(void) {
+  return HOST_HEAP_SIZE - g_host_heap_used;
+}
+
+size_t heap_bytes_used(void) {
+  return g_host_heap_used;
+}
+
+// Allocations beyond the platform's heap size fail, as on the watch:
+void *host_malloc(size_t size) {
+  uint8_t *block;
+
+  if (size > HOST_HEAP_SIZE - g_host_heap_used) {
+    return NULL;
+  }
+  block = malloc(HOST_HEAP_HEADER_SIZE + size);
+  if (block == NULL) {
+    return NULL;
+  }
+  *(size_t *) block = size;
+  g_host_heap_used += size;
+
+  return block + HOST_HEAP_HEADER_SIZE;
+}
+
+void *host_calloc(size_t count, size_t size) {
+  void *ptr = host_malloc(count * size);
+
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+
+  return ptr;
+}
+
+void host_free(void *ptr) {
+  uint8_t *block;
+
+  if (ptr == NULL) {
+    return;
+  }
+  block = (uint8_t *) ptr - HOST_HEAP_HEADER_SIZE;
+  g_host_heap_used -= *(size_t *) block;
+  free(block);
+}
+
+// Resources are read from "HOST_RESOURCES_DIR" (a copy of "resources") when
+// first requested:
+ResHandle resource_get_handle(uint32_t resource_id) {
+  char path[HOST_PATH_STR_LEN];
+  const char *directory = getenv("HOST_RESOURCES_DIR");
+  FILE *file;
+
+  if (resource_id == 0 || resource_id >= HOST_NUM_RESOURCES) {
+    return NULL;
+  }
+  if (g_host_resources[resource_id] == NULL) {
+    snprintf(path,
+             sizeof(path),
+             "%s/%s",
+             directory == NULL ? HOST_DEFAULT_RESOURCES_DIR : directory,
+             g_host_resource_files[resource_id]);
+    file = fopen(path, "rb");
+    if (file == NULL) {
+      return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    g_host_resource_sizes[resource_id] = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    g_host_resources[resource_id] =
+      malloc(g_host_resource_sizes[resource_id] + 1);
+    if (fread(g_host_resources[resource_id],
+              1,
+              g_host_resource_sizes[resource_id],
+              file) != g_host_resource_sizes[resource_id]) {
+      g_host_resource_sizes[resource_id] = 0;
+    }
+    fclose(file);
+  }
+
+  return (ResHandle) (uintptr_t) resource_id;
+}
+
+size_t resource_size(ResHandle handle) {
+  return handle == NULL ?
+           0 : g_host_resource_sizes[(uintptr_t) handle];
+}
+
+size_t resource_load(ResHandle handle, uint8_t *buffer, size_t max_length) {
+  return resource_load_byte_range(handle, 0, buffer, max_length);
+}
+
+size_t resource_load_byte_range(ResHandle handle,
+                                uint32_t start_offset,
+                                uint8_t *buffer,
+                                size_t num_bytes) {
+  const size_t size = resource_size(handle);
+
+  if (handle == NULL || start_offset >= size) {
+    return 0;
+  }
+  if (start_offset + num_bytes > size) {
+    num_bytes = size - start_offset;
+  }
+  memcpy(buffer,
+         g_host_resources[(uintptr_t) handle] + start_offset,
+         num_bytes);
+
+  return num_bytes;
+}
+
+void app_log(uint8_t log_level,
+             const char *src_filename,
+             int src_line_number,
+             const char *fmt,
+             ...) {
+  va_list args;
+
+  if (!g_host_log_enabled && getenv("HOST_LOG") == NULL) {
+    return;
+  }
+  fprintf(stderr, "%s:%d: ", src_filename, src_line_number);
+  va_start(args, fmt);
+  vfprintf(stderr, fmt, args);
+  va_end(args);
+  fputc('\n', stderr);
+}
+
+void app_event_loop(void) {}  // Drivers run their own loops.
+
+/*******************************************************************************
+   Function: host_init
+
+Description: Creates the screen's frame buffer in the target platform's format
+             (unless already done), noting the extent of each row if round.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void host_init(void) {
+#ifdef PBL_ROUND
+  int16_t y;
+
+#endif
+  if (g_host_screen != NULL) {
+    return;
+  }
+  g_host_screen = calloc(1, sizeof(GBitmap));  // (Not on the app's heap.)
+  g_host_screen->format = HOST_FRAME_BUFFER_FORMAT;
+  g_host_screen->bounds = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+  g_host_screen->row_size_bytes = HOST_FRAME_BUFFER_ROW_BYTES;
+  g_host_screen->data = calloc(HOST_FRAME_BUFFER_ROW_BYTES,
+                               PBL_DISPLAY_HEIGHT);
+  g_host_context.frame_buffer = g_host_screen;
+#ifdef PBL_ROUND
+  g_host_screen_insets = malloc(PBL_DISPLAY_HEIGHT * sizeof(int16_t));
+  for (y = 0; y < PBL_DISPLAY_HEIGHT; ++y) {
+    g_host_screen_insets[y] = host_get_circular_inset(y,
+                                                      PBL_DISPLAY_WIDTH,
+                                                      PBL_DISPLAY_HEIGHT);
+  }
+#endif
+}
+
+/*******************************************************************************
+   Function: host_render
+
+Description: Draws the top window's layers into the screen's frame buffer, as
+             the system would after "layer_mark_dirty".
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void host_render(void) {
+  Window *window = window_stack_get_top_window();
+
+  host_init();
+  if (window == NULL) {
+    return;
+  }
+  g_host_stats.frames++;
+  g_host_context.offset = GPointZero;
+  g_host_context.clip = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+  if (window->background_color.a != 0) {
+    g_host_context.fill_color = window->background_color;
+    graphics_fill_rect(&g_host_context,
+                       g_host_context.clip,
+                       0,
+                       GCornerNone);
+  }
+  host_render_layer(window->root_layer, GPointZero, g_host_context.clip);
+}
+
+/*******************************************************************************
+   Function: host_render_layer
+
+Description: Draws a layer and its children (unless hidden), clipped to the
+             layer's frame and to that of its parent.
+
+     Inputs: layer  - Pointer to the layer to draw.
+             origin - Screen coordinates of the parent layer's origin.
+             clip   - Screen area the parent layer is clipped to.
+
+    Outputs: None.
+*******************************************************************************/
+void host_render_layer(Layer *layer, GPoint origin, const GRect clip) {
+  int8_t i;
+  int16_t left, top, right, bottom;
+  GRect frame;
+
+  if (layer->hidden) {
+    return;
+  }
+  origin.x += layer->frame.origin.x;
+  origin.y += layer->frame.origin.y;
+  left = origin.x > clip.origin.x ? origin.x : clip.origin.x;
+  top = origin.y > clip.origin.y ? origin.y : clip.origin.y;
+  right = origin.x + layer->frame.size.w;
+  if (right > clip.origin.x + clip.size.w) {
+    right = clip.origin.x + clip.size.w;
+  }
+  bottom = origin.y + layer->frame.size.h;
+  if (bottom > clip.origin.y + clip.size.h) {
+    bottom = clip.origin.y + clip.size.h;
+  }
+  frame = GRect(left, top, right - left, bottom - top);
+  g_host_context.offset = origin;
+  g_host_context.clip = frame;
+  if (layer->filled && layer->background_color.a != 0) {
+    g_host_context.fill_color = layer->background_color;
+    graphics_fill_rect(&g_host_context,
+                       layer_get_bounds(layer),
+                       0,
+                       GCornerNone);
+  }
+  if (layer->update_proc != NULL) {
+    layer->update_proc(layer, &g_host_context);
+  }
+  for (i = 0; i < layer->num_children; ++i) {
+    host_render_layer(layer->children[i], origin, frame);
+  }
+}
+
+/*******************************************************************************
+   Function: host_click
+
+Description: Simulates a click of one of the watch's buttons by calling the
+             handler the top window subscribed for it (if any).
+
+     Inputs: button - Which button is clicked.
+             kind   - Kind of click ("SINGLE_CLICK", "MULTI_CLICK" or
+                      "LONG_CLICK").
+
+    Outputs: None.
+*******************************************************************************/
+void host_click(const ButtonId button, const int8_t kind) {
+  if (g_host_click_handlers[button][kind] != NULL) {
+    g_host_click_handlers[button][kind](NULL, NULL);
+  }
+}
+
+/*******************************************************************************
+   Function: host_tick
+
+Description: Calls the tick timer service's handler (if any), as the system
+             would once per second.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void host_tick(void) {
+  const time_t now = time(NULL);
+
+  if (g_host_tick_handler != NULL) {
+    g_host_tick_handler(localtime(&now), SECOND_UNIT);
+  }
+}
+
+/*******************************************************************************
+   Function: host_advance_time
+
+Description: Moves the virtual clock forward, firing any app timers that fall
+             due (including those registered by other timers' callbacks).
+
+     Inputs: milliseconds - How far to move the clock.
+
+    Outputs: None.
+*******************************************************************************/
+void host_advance_time(const uint32_t milliseconds) {
+  int8_t i;
+  bool fired;
+
+  g_host_virtual_time += milliseconds;
+  do {
+    fired = false;
+    for (i = 0; i < HOST_MAX_TIMERS; ++i) {
+      if (g_host_timers[i].active &&
+          g_host_timers[i].due_time <= g_host_virtual_time) {
+        g_host_timers[i].active = false;
+        g_host_timers[i].callback(g_host_timers[i].data);
+        fired = true;
+      }
+    }
+  } while (fired);
+}
+
+/*******************************************************************************
+   Function: host_read_pixel
+
+Description: Returns the color of a pixel on the screen.
+
+     Inputs: x - Horizontal screen coordinate.
+             y - Vertical screen coordinate.
+
+    Outputs: The pixel's color in 8-bit ARGB format (black or white on 1-bit
+             platforms).
+*******************************************************************************/
+uint8_t host_read_pixel(const int16_t x, const int16_t y) {
+  host_init();
+#ifdef PBL_BW
+  return host_read_bitmap_bit(g_host_screen, x, y) ?
+           GColorWhite.argb : GColorBlack.argb;
+#else
+  return g_host_screen->data[y * g_host_screen->row_size_bytes + x];
+#endif
+}
+
+/*******************************************************************************
+   Function: host_write_ppm
+
+Description: Writes the screen out as a binary PPM image.
+
+     Inputs: path - Path of the image file to create (or overwrite).
+
+    Outputs: "True" if the image is successfully written.
+*******************************************************************************/
+bool host_write_ppm(const char *const path) {
+  int16_t x, y;
+  uint8_t argb, rgb[3];
+  FILE *file = fopen(path, "wb");
+
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "P6\n%d %d\n255\n", PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+  for (y = 0; y < PBL_DISPLAY_HEIGHT; ++y) {
+    for (x = 0; x < PBL_DISPLAY_WIDTH; ++x) {
+      argb = host_read_pixel(x, y);
+      rgb[0] = ((argb >> 4) & 3) * 85;  // Each channel has two bits.
+      rgb[1] = ((argb >> 2) & 3) * 85;
+      rgb[2] = (argb & 3) * 85;
+      fwrite(rgb, 1, sizeof(rgb), file);
+    }
+  }
+
+  return fclose(file) == 0;
+}
+
+/*******************************************************************************
+   Function: host_frame_hash
+
+Description: Returns a hash of the screen's contents (FNV-1a over each pixel's
+             color), for comparing frames against known-good ones.
+
+     Inputs: None.
+
+    Outputs: 64-bit hash of the screen.
+*******************************************************************************/
+uint64_t host_frame_hash(void) {
+  int16_t x, y;
+  uint64_t hash = HOST_FNV_OFFSET_BASIS;
+
+  for (y = 0; y < PBL_DISPLAY_HEIGHT; ++y) {
+    for (x = 0; x < PBL_DISPLAY_WIDTH; ++x) {
+      hash = (hash ^ host_read_pixel(x, y)) * HOST_FNV_PRIME;
+    }
+  }
+
+  return hash;
+}
+
+/*******************************************************************************
+   Function: host_begin_capture
+
+Description: Called when the app captures the frame buffer. If pixels written
+             directly to it are being counted, snapshots the screen so they
+             can be found afterward.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void host_begin_capture(void) {
+  const size_t size = g_host_screen->row_size_bytes *
+                        g_host_screen->bounds.size.h;
+
+  if (g_host_count_capture_pixels) {
+    g_host_capture_snapshot = realloc(g_host_capture_snapshot, size);
+    memcpy(g_host_capture_snapshot, g_host_screen->data, size);
+  }
+}
+
+/*******************************************************************************
+   Function: host_end_capture
+
+Description: Called when the app releases the frame buffer. If pixels written
+             directly to it are being counted, adds those that changed since
+             "host_begin_capture" to "g_host_stats.pixels_drawn".
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void host_end_capture(void) {
+  int16_t x, y;
+  bool changed;
+  const uint8_t *before, *after;
+
+  if (!g_host_count_capture_pixels) {
+    return;
+  }
+  for (y = 0; y < g_host_screen->bounds.size.h; ++y) {
+    before = g_host_capture_snapshot + y * g_host_screen->row_size_bytes;
+    after = g_host_screen->data + y * g_host_screen->row_size_bytes;
+    for (x = 0; x < g_host_screen->bounds.size.w; ++x) {
+#ifdef PBL_BW
+      changed = ((before[x / 8] ^ after[x / 8]) >> (x % 8)) & 1;
+#else
+      changed = before[x] != after[x];
+#endif
+      if (changed) {
+        g_host_stats.pixels_drawn++;
+      }
+    }
+  }
+}
+
+/*******************************************************************************
+   Function: host_plot
+
+Description: Draws a single pixel via the graphics context, offset by the
+             layer being drawn and clipped to it. (Nothing can be drawn this
+             way while the frame buffer is captured, as on the watch.)
+
+     Inputs: ctx   - Pointer to the graphics context.
+             x     - Horizontal coordinate within the layer.
+             y     - Vertical coordinate within the layer.
+             color - Color to draw (ignored if clear).
+
+    Outputs: "True" if the pixel is drawn.
+*******************************************************************************/
+bool host_plot(GContext *ctx, int16_t x, int16_t y, const GColor color) {
+  x += ctx->offset.x;
+  y += ctx->offset.y;
+  if (ctx->frame_buffer_captured ||
+      x < ctx->clip.origin.x ||
+      x >= ctx->clip.origin.x + ctx->clip.size.w ||
+      y < ctx->clip.origin.y ||
+      y >= ctx->clip.origin.y + ctx->clip.size.h ||
+      x < 0 ||
+      x >= PBL_DISPLAY_WIDTH ||
+      y < 0 ||
+      y >= PBL_DISPLAY_HEIGHT) {
+    return false;
+  }
+  host_write_pixel(x, y, color);
+  g_host_stats.pixels_drawn++;
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: host_write_pixel
+
+Description: Sets a pixel on the screen. On 1-bit platforms, lighter colors
+             become white and darker ones black; on round ones, pixels
+             outside the display's circle are left alone.
+
+     Inputs: x     - Horizontal screen coordinate.
+             y     - Vertical screen coordinate.
+             color - Color to write (ignored if clear).
+
+    Outputs: None.
+*******************************************************************************/
+void host_write_pixel(const int16_t x, const int16_t y, const GColor color) {
+#ifdef PBL_BW
+  uint8_t *byte;
+#else
+  GBitmapDataRowInfo row_info;
+#endif
+
+  if (color.a == 0) {
+    return;
+  }
+#ifdef PBL_BW
+  byte = g_host_screen->data + y * g_host_screen->row_size_bytes + x / 8;
+  if (color.r + color.g + color.b >= 5) {
+    *byte |= 1 << (x % 8);
+  } else {
+    *byte &= ~(1 << (x % 8));
+  }
+#else
+  row_info = gbitmap_get_data_row_info(g_host_screen, y);
+  if (x >= row_info.min_x && x <= row_info.max_x) {
+    row_info.data[x] = color.argb;
+  }
+#endif
+}
+
+/*******************************************************************************
+   Function: host_read_bitmap_bit
+
+Description: Returns a pixel of a 1-bit bitmap (least significant bit first).
+
+     Inputs: bitmap - Pointer to the bitmap.
+             x      - Horizontal coordinate within the bitmap.
+             y      - Vertical coordinate within the bitmap.
+
+    Outputs: "True" if the pixel is white.
+*******************************************************************************/
+bool host_read_bitmap_bit(const GBitmap *const bitmap,
+                          const int16_t x,
+                          const int16_t y) {
+  return (bitmap->data[y * bitmap->row_size_bytes + x / 8] >> (x % 8)) & 1;
+}
+
+/*******************************************************************************
+   Function: host_get_circular_inset
+
+Description: Returns how many pixels at either end of a row lie outside a
+             round display (a circle inscribed in its square frame buffer).
+
+     Inputs: y      - Row of interest.
+             width  - Width of the frame buffer.
+             height - Height of the frame buffer.
+
+    Outputs: No. of pixels outside the circle at each end of the row.
+*******************************************************************************/
+int16_t host_get_circular_inset(const int16_t y,
+                                const int16_t width,
+                                const int16_t height) {
+  const float radius = width / 2.0f,
+              dy = y + 0.5f - height / 2.0f;
+
+  if (dy * dy > radius * radius) {
+    return width / 2;
+  }
+
+  return (int16_t) (radius - sqrtf(radius * radius - dy * dy) + 0.5f);
+}
+
+/*******************************************************************************
+   Function: host_get_path_point
+
+Description: Returns one of a path's points, rotated and moved into place.
+
+     Inputs: path - Pointer to the path.
+             i    - Index of the point.
+
+    Outputs: The point's coordinates.
+*******************************************************************************/
+GPoint host_get_path_point(const GPath *const path, const uint32_t i) {
+  const int32_t cosine = cos_lookup(path->rotation),
+                sine = sin_lookup(path->rotation);
+  const GPoint point = path->points[i];
+
+  return GPoint((point.x * cosine - point.y * sine) / TRIG_MAX_RATIO +
+                  path->offset.x,
+                (point.y * cosine + point.x * sine) / TRIG_MAX_RATIO +
+                  path->offset.y);
+}
+
+/*******************************************************************************
+   Function: host_find_persistent_value
+
+Description: Looks up a value in (simulated) persistent storage.
+
+     Inputs: key - Key the value was written under.
+
+    Outputs: Index of the value in "g_host_persistent_values", or -1 if none
+             exists.
+*******************************************************************************/
+int8_t host_find_persistent_value(const uint32_t key) {
+  int8_t i;
+
+  for (i = 0; i < HOST_MAX_PERSIST_KEYS; ++i) {
+    if (g_host_persistent_values[i].used &&
+        g_host_persistent_values[i].key == key) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+/*******************************************************************************
+   Function: host_get_render_engine
+
+Description: Looks up one of the app's render engines by name (see
+             "g_host_render_engine_names").
+
+     Inputs: name - The engine's name.
+
+    Outputs: The engine, or -1 if there's no such engine.
+*******************************************************************************/
+int8_t host_get_render_engine(const char *const name) {
+  int8_t engine;
+
+  for (engine = 0; engine < HOST_NUM_RENDER_ENGINES; ++engine) {
+    if (strcmp(name, g_host_render_engine_names[engine]) == 0) {
+      return engine;
+    }
+  }
+
+  return -1;
+}
@@ -0,0 +1,224 @@
+/*******************************************************************************
+   Filename: pebble_host.h
+
+     Author: David C. Drake (https://davidcdrake.com)
+
+Description: Header file for the host-side stand-in for the Pebble SDK, which
+             lets MazeCrawler be built and run headless on an ordinary
+             computer (see "host/Makefile"). Drawing calls are rasterized into
+             an in-memory frame buffer matching the target platform's display,
+             which can then be hashed or written out as a PPM image.
+*******************************************************************************/
+
+#ifndef PEBBLE_HOST_H_
+#define PEBBLE_HOST_H_
+
+#include "pebble.h"
+
+/*******************************************************************************
+  Enumerations
+*******************************************************************************/
+
+// Kinds of clicks (see "host_click"):
+enum {
+  SINGLE_CLICK,
+  MULTI_CLICK,
+  LONG_CLICK,
+  NUM_CLICK_KINDS
+};
+
+/*******************************************************************************
+  Other Constants
+*******************************************************************************/
+
+#define HOST_MAX_CHILD_LAYERS            16  // Per layer.
+#define HOST_MAX_WINDOWS                 8  // Max. size of the window stack.
+#define HOST_MAX_TIMERS                  16
+#define HOST_MAX_PERSIST_KEYS            32
+#define HOST_DEFAULT_RESOURCES_DIR       "resources"  // Unless "HOST_RESOURCES_DIR" is set.
+#define HOST_PATH_STR_LEN                512
+#define HOST_NUM_RENDER_ENGINES          2  // See "g_host_render_engine_names".
+#define HOST_STATUS_BAR_HEIGHT           PBL_IF_ROUND_ELSE(24, 16)
+#define HOST_NUM_RESOURCES               (sizeof(g_host_resource_files) / sizeof(g_host_resource_files[0]))
+#define HOST_FNV_OFFSET_BASIS            1469598103934665603ULL  // For "host_frame_hash".
+#define HOST_FNV_PRIME                   1099511628211ULL
+#if defined(PBL_PLATFORM_APLITE)
+#define HOST_PLATFORM_NAME               "aplite"
+#define HOST_HEAP_SIZE                   24576  // App memory, of which code and static data aren't deducted here.
+#elif defined(PBL_PLATFORM_CHALK)
+#define HOST_PLATFORM_NAME               "chalk"
+#define HOST_HEAP_SIZE                   65536
+#elif defined(PBL_PLATFORM_EMERY)
+#define HOST_PLATFORM_NAME               "emery"
+#define HOST_HEAP_SIZE                   131072
+#else
+#define HOST_PLATFORM_NAME               "basalt"
+#define HOST_HEAP_SIZE                   65536
+#endif
+#define HOST_HEAP_HEADER_SIZE            16  // Before each block, holding its size (and keeping it aligned).
+#ifdef PBL_COLOR
+#define HOST_FRAME_BUFFER_FORMAT         PBL_IF_ROUND_ELSE(GBitmapFormat8BitCircular, GBitmapFormat8Bit)
+#define HOST_FRAME_BUFFER_ROW_BYTES      PBL_DISPLAY_WIDTH
+#else
+#define HOST_FRAME_BUFFER_FORMAT         GBitmapFormat1Bit
+#define HOST_FRAME_BUFFER_ROW_BYTES      20  // As on aplite (i.e., padded to 160 pixels).
+#endif
+
+/*******************************************************************************
+  Structures
+*******************************************************************************/
+
+struct GBitmap {
+  GBitmapFormat format;
+  GRect bounds;
+  uint16_t row_size_bytes;
+  uint8_t *data;
+};
+
+struct Layer {
+  GRect frame;
+  LayerUpdateProc update_proc;
+  Layer *parent,
+        *children[HOST_MAX_CHILD_LAYERS];
+  int8_t num_children;
+  bool hidden,
+       filled;  // Whether "background_color" is painted (as for text layers).
+  GColor background_color;
+  void *data;
+};
+
+struct TextLayer {
+  Layer layer;
+  const char *text;
+};
+
+struct StatusBarLayer {
+  Layer layer;
+};
+
+struct MenuLayer {
+  Layer layer;
+};
+
+struct Window {
+  Layer *root_layer;
+  GColor background_color;
+  WindowHandlers handlers;
+  ClickConfigProvider click_config_provider;
+};
+
+struct GContext {
+  GColor stroke_color,
+         fill_color;
+  GPoint offset;  // Of the layer being drawn, in screen coordinates.
+  GRect clip;
+  GBitmap *frame_buffer;
+  bool frame_buffer_captured;
+};
+
+struct GPath {
+  uint32_t num_points;
+  GPoint *points,
+         offset;
+  int32_t rotation;
+};
+
+struct AppTimer {
+  bool active;
+  uint64_t due_time;  // Virtual milliseconds (see "host_advance_time").
+  AppTimerCallback callback;
+  void *data;
+};
+
+typedef struct HostPersistentValue {
+  bool used;
+  uint32_t key;
+  size_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} host_persistent_value_t;
+
+// Counts of SDK calls and pixels drawn (reset freely by drivers):
+typedef struct HostStats {
+  uint32_t frames,
+           pixel_calls,
+           line_calls,
+           rect_calls,
+           circle_calls,
+           path_calls,
+           bitmap_calls,
+           stroke_color_calls,
+           fill_color_calls,
+           capture_calls,
+           text_updates,
+           dirty_marks,
+           persist_writes;
+  uint64_t pixels_drawn;  // Via the graphics context or, if counted, directly.
+} host_stats_t;
+
+/*******************************************************************************
+  Precomputed Tables
+*******************************************************************************/
+
+// Paths of the app's resources, indexed by resource ID (see
+// "generate_resource_ids.py"):
+static const char *const g_host_resource_files[] = HOST_RESOURCE_FILES;
+
+/*******************************************************************************
+  Global Variables
+*******************************************************************************/
+
+host_stats_t g_host_stats;
+size_t g_host_heap_used;  // Bytes allocated on the app's heap.
+bool g_host_log_enabled,  // Whether "APP_LOG" messages are printed (as they
+                          // also are if "HOST_LOG" is set).
+     g_host_count_capture_pixels;  // Whether to diff captured frame buffers.
+GBitmap *g_host_screen;
+int16_t *g_host_screen_insets;  // Per row, if round (see "host_init").
+GContext g_host_context;
+Window *g_host_window_stack[HOST_MAX_WINDOWS];
+int8_t g_host_window_stack_size;
+ClickHandler g_host_click_handlers[NUM_BUTTONS][NUM_CLICK_KINDS];
+TickHandler g_host_tick_handler;
+AppFocusHandler g_host_focus_handler;
+AppTimer g_host_timers[HOST_MAX_TIMERS];
+uint64_t g_host_virtual_time;  // Milliseconds (see "time_ms").
+host_persistent_value_t g_host_persistent_values[HOST_MAX_PERSIST_KEYS];
+
+// The app's render engines (in the order of "maze_crawler.h"), as named on the
+// host tools' command lines:
+static const char *const g_host_render_engine_names[HOST_NUM_RENDER_ENGINES] = {
+  "grid",
+  "raycast",
+};
+uint8_t *g_host_capture_snapshot,
+        *g_host_resources[HOST_NUM_RESOURCES];  // Loaded on demand.
+size_t g_host_resource_sizes[HOST_NUM_RESOURCES];
+
+/*******************************************************************************
+  Function Declarations
+*******************************************************************************/
+
+void host_init(void);
+void host_render(void);
+void host_render_layer(Layer *layer, GPoint origin, const GRect clip);
+void host_click(const ButtonId button, const int8_t kind);
+void host_tick(void);
+void host_advance_time(const uint32_t milliseconds);
+uint8_t host_read_pixel(const int16_t x, const int16_t y);
+bool host_write_ppm(const char *const path);
+uint64_t host_frame_hash(void);
+void host_begin_capture(void);
+void host_end_capture(void);
+bool host_plot(GContext *ctx, int16_t x, int16_t y, const GColor color);
+void host_write_pixel(const int16_t x, const int16_t y, const GColor color);
+bool host_read_bitmap_bit(const GBitmap *const bitmap,
+                          const int16_t x,
+                          const int16_t y);
+int16_t host_get_circular_inset(const int16_t y,
+                                const int16_t width,
+                                const int16_t height);
+GPoint host_get_path_point(const GPath *const path, const uint32_t i);
+int8_t host_find_persistent_value(const uint32_t key);
+int8_t host_get_render_engine(const char *const name);
+
+#endif  // PEBBLE_HOST_H_
@@ -0,0 +1,180 @@
+/*******************************************************************************
+   Filename: render.c
+
+     Author: David C. Drake (https://davidcdrake.com)
+
+Description: Headless renderer for MazeCrawler's 3D view, built against the
+             host-side stand-in for the Pebble SDK (see "host/Makefile").
+             Renders either a single view or every view of a series of mazes,
+             printing a hash of each frame (so runs can be diffed against
+             known-good output) and optionally writing PPM images:
+
+                 render [--engine <grid|raycast>] <seed> <x> <y> <direction>
+                    [<image path>]
+                 render [--engine <grid|raycast>] --all <no. of mazes>
+                    [<image directory>]
+
+             Mazes are generated from seeds 1, 2, 3, etc. (or from the given
+             seed, e.g., one logged by the app, in decimal or "0x" hex) by
+             restarting the next maze's generation and calling "init_maze" to
+             finish it, so they match the app's mazes with the same seeds.
+             Directions are numbered as in "maze_crawler.h" (north, south,
+             east, west). Views are drawn by the given render engine
+             (default: the platform's "DEFAULT_RENDER_ENGINE").
+*******************************************************************************/
+
+#include "pebble_host.h"
+#define main maze_crawler_main  // The app's "main" is renamed in this build.
+#include "maze_crawler.h"
+#undef main
+
+#define RENDER_USAGE \
+  "usage: render [--engine <grid|raycast>] <seed> <x> <y> <direction> " \
+  "[<image path>]\n" \
+  "       render [--engine <grid|raycast>] --all <no. of mazes> " \
+  "[<image directory>]\n"
+
+void render_view(const GPoint position, const int8_t direction);
+void print_frame(const uint32_t seed,
+                 const GPoint position,
+                 const int8_t direction,
+                 const char *const image_path);
+
+/*******************************************************************************
+   Function: main
+
+Description: Parses the command line, starts the app, selects the requested
+             render engine and renders the requested view(s).
+
+     Inputs: argc - No. of command-line arguments.
+             argv - Command-line arguments (see above).
+
+    Outputs: Exit status (non-zero if the arguments are invalid or an image
+             can't be written).
+*******************************************************************************/
+int main(int argc, char **argv) {
+  uint32_t seed;
+  int num_mazes;
+  int8_t x, y, direction, engine = DEFAULT_RENDER_ENGINE;
+  char image_path[HOST_PATH_STR_LEN];
+  const char *image_directory;
+
+  if (argc >= 3 && strcmp(argv[1], "--engine") == 0) {
+    engine = host_get_render_engine(argv[2]);
+#ifndef RAYCASTING_ENGINE_ENABLED
+    if (engine == RAYCASTING_ENGINE) {
+      engine = -1;  // Compiled out (see "RAYCASTING_ENGINE_ENABLED").
+    }
+#endif
+    argc -= 2;
+    argv += 2;
+  }
+  if (engine >= 0 && argc >= 3 && argc <= 4 && strcmp(argv[1], "--all") == 0) {
+    num_mazes = atoi(argv[2]);
+    image_directory = argc == 4 ? argv[3] : NULL;
+  } else if (engine >= 0 && argc >= 5 && argc <= 6) {
+    num_mazes = 0;
+  } else {
+    fprintf(stderr, RENDER_USAGE);
+
+    return 1;
+  }
+  init();
+  window_stack_push(g_graphics_window, NOT_ANIMATED);
+  g_render_engine = engine;
+  clear_frame_cache();  // (It isn't keyed by engine.)
+
+  // Render a single view:
+  if (num_mazes == 0) {
+    seed = strtoul(argv[1], NULL, 0);
+    begin_maze_generation(seed);
+    init_maze();
+    print_frame(seed,
+                GPoint(atoi(argv[2]), atoi(argv[3])),
+                atoi(argv[4]),
+                argc == 6 ? argv[5] : NULL);
+
+    return 0;
+  }
+
+  // Render every view of each maze:
+  for (seed = 1; seed <= (uint32_t) num_mazes; ++seed) {
+    begin_maze_generation(seed);
+    init_maze();
+    for (x = 0; x < g_maze->width; ++x) {
+      for (y = 0; y < g_maze->height; ++y) {
+        if (is_solid(GPoint(x, y))) {
+          continue;
+        }
+        for (direction = 0; direction < NUM_DIRECTIONS; ++direction) {
+          if (image_directory != NULL) {
+            snprintf(image_path,
+                     sizeof(image_path),
+                     "%s/%lu_%d_%d_%d.ppm",
+                     image_directory,
+                     (unsigned long) seed,
+                     x,
+                     y,
+                     direction);
+          }
+          print_frame(seed,
+                      GPoint(x, y),
+                      direction,
+                      image_directory == NULL ? NULL : image_path);
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+   Function: render_view
+
+Description: Moves the player to a given cell and direction and draws the
+             screen.
+
+     Inputs: position  - Cell to view the maze from.
+             direction - Direction to face.
+
+    Outputs: None.
+*******************************************************************************/
+void render_view(const GPoint position, const int8_t direction) {
+  g_player->position = position;
+  g_player->direction = direction;
+  g_scene_dirty = true;
+  update_compass();
+  layer_mark_dirty(g_scene_layer);
+  host_render();
+}
+
+/*******************************************************************************
+   Function: print_frame
+
+Description: Renders a view, prints its hash and (optionally) writes it out as
+             a PPM image. Exits if the image can't be written.
+
+     Inputs: seed       - Seed the maze was generated from.
+             position   - Cell to view the maze from.
+             direction  - Direction to face.
+             image_path - Path of the image to write, or "NULL".
+
+    Outputs: None.
+*******************************************************************************/
+void print_frame(const uint32_t seed,
+                 const GPoint position,
+                 const int8_t direction,
+                 const char *const image_path) {
+  render_view(position, direction);
+  printf("%lu %d %d %d %016llx\n",
+         (unsigned long) seed,
+         position.x,
+         position.y,
+         direction,
+         (unsigned long long) host_frame_hash());
+  if (image_path != NULL && !host_write_ppm(image_path)) {
+    fprintf(stderr, "render: can't write \"%s\"\n", image_path);
+    exit(1);
+  }
+}
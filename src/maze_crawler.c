@@ -132,7 +132,7 @@ void init_player(void) {
   int8_t i;
 
   g_player->position = GPoint(0, 0);
-  g_player->direction = rand() % NUM_DIRECTIONS;
+  g_player->direction = get_random(&g_random) % NUM_DIRECTIONS;
   g_player->level = 1;
   g_player->points = 0;
   g_player->best_time = MAX_SECONDS;
@@ -142,38 +142,76 @@ void init_player(void) {
 }
 
 /*******************************************************************************
-   Function: update_status_bar
+   Function: update_level_text
 
-Description: Updates the text displayed in the lower status bar.
+Description: Updates the level number displayed in the lower status bar.
 
-     Inputs: ctx - Pointer to the relevant graphics context.
+     Inputs: None.
 
     Outputs: None.
 *******************************************************************************/
-void update_status_bar(GContext *ctx) {
-  static char level_str[LEVEL_STR_LEN + 1], time_str[TIME_STR_LEN + 1];
+void update_level_text(void) {
+  static char level_str[LEVEL_STR_LEN + 1];
 
-  // Display the current level number:
   strcpy(level_str, "");
   snprintf(level_str, LEVEL_STR_LEN + 1, "L. %d", g_player->level);
   text_layer_set_text(g_level_text_layer, level_str);
+}
+
+/*******************************************************************************
+   Function: update_time_text
+
+Description: Updates the amount of time spent in the current maze, as displayed
+             in the lower status bar.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void update_time_text(void) {
+  static char time_str[TIME_STR_LEN + 1];
 
-  // Display the amount of time spent in the current maze:
   strcpy(time_str, "");
   strcat_time(time_str, g_maze->seconds);
   text_layer_set_text(g_time_text_layer, time_str);
+}
+
+/*******************************************************************************
+   Function: draw_lower_status_bar
+
+Description: Clears the lower status bar's background. (The level and time text
+             layers and the compass layer are drawn on top of it.)
+
+     Inputs: layer - Pointer to the lower status bar layer.
+             ctx   - Pointer to the relevant graphics context.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_lower_status_bar(Layer *layer, GContext *ctx) {
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_fill_rect(ctx,
+                     layer_get_bounds(layer),
+                     NO_CORNER_RADIUS,
+                     GCornerNone);
+}
+
+/*******************************************************************************
+   Function: draw_compass
 
-  // Draw the compass:
+Description: Draws the compass in the lower status bar.
+
+     Inputs: layer - Pointer to the compass layer.
+             ctx   - Pointer to the relevant graphics context.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_compass(Layer *layer, GContext *ctx) {
 #ifdef PBL_COLOR
   graphics_context_set_fill_color(ctx, GColorLightGray);
 #else
   graphics_context_set_fill_color(ctx, GColorWhite);
 #endif
-  graphics_fill_circle(ctx,
-                       GPoint(HALF_SCREEN_WIDTH,
-                              GRAPHICS_FRAME_HEIGHT + STATUS_BAR_HEIGHT +
-                                STATUS_BAR_HEIGHT / 2),
-                       COMPASS_RADIUS);
+  graphics_fill_circle(ctx, COMPASS_CENTER, COMPASS_RADIUS);
 #ifdef PBL_COLOR
   graphics_context_set_stroke_color(ctx, GColorDarkGray);
 #else
@@ -188,7 +226,7 @@ void update_status_bar(GContext *ctx) {
    Function: update_compass
 
 Description: Updates the rotation angle of the compass needle according to the
-             player's current direction.
+             player's current direction, then marks the compass layer dirty.
 
      Inputs: None.
 
@@ -203,12 +241,179 @@ void update_compass(void) {
       gpath_rotate_to(g_compass_path, 0);
       break;
     case EAST:
-      gpath_rotate_to(g_compass_path, TRIG_MAX_ANGLE * 0.75);
+      gpath_rotate_to(g_compass_path, TRIG_MAX_ANGLE * 3 / 4);
       break;
     default:  // case WEST:
       gpath_rotate_to(g_compass_path, TRIG_MAX_ANGLE / 4);
       break;
   }
+  layer_mark_dirty(g_compass_layer);
+}
+
+/*******************************************************************************
+   Function: reset_minimap
+
+Description: Forgets which cells of the maze have been explored and clears the
+             minimap, then reveals the cells around the player. (Called
+             whenever a new maze is generated.)
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void reset_minimap(void) {
+  memset(g_minimap.explored, 0, sizeof(g_minimap.explored));
+  redraw_minimap();
+  reveal_minimap_cells(g_player->position);
+}
+
+/*******************************************************************************
+   Function: redraw_minimap
+
+Description: Redraws the entire minimap bitmap from "g_minimap" (e.g., after
+             the minimap's been loaded from persistent storage). Otherwise the
+             bitmap is only ever updated a cell at a time.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void redraw_minimap(void) {
+  int8_t x, y;
+
+  if (g_minimap_bitmap == NULL) {
+    return;
+  }
+  memset(gbitmap_get_data(g_minimap_bitmap),
+#ifdef PBL_COLOR
+         MINIMAP_UNEXPLORED_COLOR.argb,
+#else
+         0,
+#endif
+         gbitmap_get_bytes_per_row(g_minimap_bitmap) * MINIMAP_SIZE);
+  for (x = 0; x < g_maze->width; ++x) {
+    for (y = 0; y < g_maze->height; ++y) {
+      if (MINIMAP_IS_EXPLORED(x, y)) {
+        draw_minimap_cell(GPoint(x, y));
+      }
+    }
+  }
+  layer_mark_dirty(g_minimap_layer);
+}
+
+/*******************************************************************************
+   Function: reveal_minimap_cells
+
+Description: Marks a given cell and its neighbors as explored, drawing any that
+             weren't already onto the minimap. (At most five cells are drawn,
+             so the minimap costs next to nothing per step.)
+
+     Inputs: position - The cell the player has just entered.
+
+    Outputs: None.
+*******************************************************************************/
+void reveal_minimap_cells(const GPoint position) {
+  int8_t direction;
+  GPoint cell;
+
+  if (g_endless.enabled) {
+    return;  // The minimap only covers the current maze.
+  }
+  for (direction = -1; direction < NUM_DIRECTIONS; ++direction) {
+    cell = direction < 0 ? position : get_cell_farther_away(position,
+                                                            direction,
+                                                            1);
+    if (out_of_bounds(cell) || MINIMAP_IS_EXPLORED(cell.x, cell.y)) {
+      continue;
+    }
+    g_minimap.explored[cell.y][cell.x / 8] |= 1 << (cell.x % 8);
+    draw_minimap_cell(cell);
+  }
+  layer_mark_dirty(g_minimap_layer);
+}
+
+/*******************************************************************************
+   Function: draw_minimap_cell
+
+Description: Writes a single explored cell into the minimap bitmap: walls and
+             open floor in their own colors, with a dot marking the exit.
+             (Cells are scaled so the whole maze fits, however large.)
+
+     Inputs: cell - Coordinates of the cell within the maze.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_minimap_cell(const GPoint cell) {
+  int16_t dx, dy, x;
+  uint8_t *row;
+  GColor color;
+  const int8_t type = get_cell_type(cell);
+  const int16_t cell_size = MINIMAP_CELL_SIZE;
+
+  if (g_minimap_bitmap == NULL) {
+    return;
+  }
+  for (dy = 0; dy < cell_size; ++dy) {
+    row = gbitmap_get_data(g_minimap_bitmap) +
+            (cell.y * cell_size + dy) *
+            gbitmap_get_bytes_per_row(g_minimap_bitmap);
+    for (dx = 0; dx < cell_size; ++dx) {
+      if (type == SOLID) {
+        color = MINIMAP_WALL_COLOR;
+      } else if (type == EXIT && dx == cell_size / 2 &&
+                 dy == cell_size / 2) {
+        color = GColorBlack;
+      } else {
+        color = MINIMAP_FLOOR_COLOR;
+      }
+      x = cell.x * cell_size + dx;
+#ifdef PBL_COLOR
+      row[x] = color.argb;
+#else
+      if (gcolor_equal(color, GColorWhite)) {
+        row[x / 8] |= 1 << (x % 8);
+      } else {
+        row[x / 8] &= ~(1 << (x % 8));
+      }
+#endif
+    }
+  }
+}
+
+/*******************************************************************************
+   Function: draw_minimap
+
+Description: Draws the minimap over the 3D view: the cached bitmap of explored
+             cells, plus a marker for the player's current cell.
+
+     Inputs: layer - Pointer to the minimap layer.
+             ctx   - Pointer to the relevant graphics context.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_minimap(Layer *layer, GContext *ctx) {
+  const int16_t cell_size = MINIMAP_CELL_SIZE;
+  const GRect player_rect = GRect(g_player->position.x * cell_size,
+                                  g_player->position.y * cell_size,
+                                  cell_size,
+                                  cell_size);
+
+  if (g_minimap_bitmap == NULL) {
+    return;
+  }
+  graphics_draw_bitmap_in_rect(ctx,
+                               g_minimap_bitmap,
+                               layer_get_bounds(layer));
+  graphics_context_set_fill_color(ctx, MINIMAP_PLAYER_COLOR);
+  graphics_fill_rect(ctx, player_rect, NO_CORNER_RADIUS, GCornerNone);
+#ifdef PBL_BW
+  if (cell_size >= MINIMAP_MIN_RING_SIZE) {
+    graphics_context_set_stroke_color(ctx, GColorWhite);  // Hollow center.
+    graphics_draw_pixel(ctx,
+                        GPoint(player_rect.origin.x + cell_size / 2,
+                               player_rect.origin.y + cell_size / 2));
+  }
+#endif
 }
 
 /*******************************************************************************
@@ -240,7 +445,9 @@ Description: Attempts to move the player one cell forward in a given direction
 *******************************************************************************/
 bool move_player(const int8_t direction) {
   if (shift_position(&(g_player->position), direction)) {
-    layer_mark_dirty(window_get_root_layer(g_graphics_window));
+    g_scene_dirty = true;
+    layer_mark_dirty(g_scene_layer);
+    reveal_minimap_cells(g_player->position);
     check_for_maze_completion();
 
     return true;
@@ -328,7 +535,7 @@ bool check_for_maze_completion(void) {
     }
 
     // Build a congratulatory message:
-    switch(rand() % 30) {
+    switch(get_random(&g_random) % 30) {
       case 0:
         strcpy(g_message_str, "A-maze-ing");
         break;
@@ -506,502 +713,3082 @@ bool check_for_maze_completion(void) {
 }
 
 /*******************************************************************************
-   Function: init_wall_coords
+   Function: init_maze
 
-Description: Initializes the global "back_wall_coords" array so it contains the
-             top-left and bottom-right coordinates for every potential back wall
-             location on the screen. (This establishes the field of view and
-             sense of perspective while also facilitating convenient drawing of
-             the 3D environment.)
+Description: Swaps in the next maze, which is normally already generated in the
+             background (see "begin_maze_generation"), finishing it first if
+             need be (see "finish_maze_generation"). Also repositions the
+             player, sets the number of seconds spent in the maze to zero, logs
+             the maze's seed (so a maze can be reported and replayed), schedules
+             a save to persistent storage as a precaution, and starts
+             generating the maze after this one (logging the heap's usage once
+             both mazes are allocated). Slow work (generation and flash writes)
+             is thus kept out of the button handler that completes a level.
 
      Inputs: None.
 
     Outputs: None.
 *******************************************************************************/
-void init_wall_coords(void) {
-  uint8_t i, j, wall_width;
-  const float perspective_modifier = 2.0;  // Helps determine FOV, etc.
-
-  for (i = 0; i < MAX_VISIBILITY_DEPTH - 1; ++i) {
-    for (j = 0; j < (STRAIGHT_AHEAD * 2) + 1; ++j) {
-      g_back_wall_coords[i][j][TOP_LEFT] = GPoint(0, 0);
-      g_back_wall_coords[i][j][BOTTOM_RIGHT] = GPoint(0, 0);
-    }
+void init_maze(void) {
+  if (g_maze_generator.maze == NULL) {
+    begin_maze_generation(get_new_maze_seed());
   }
-  for (i = 0; i < MAX_VISIBILITY_DEPTH - 1; ++i) {
-    g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT] =
-      GPoint(FIRST_WALL_OFFSET - i * perspective_modifier,
-             FIRST_WALL_OFFSET - i * perspective_modifier);
-    if (i > 0) {
-      g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT].x +=
-        g_back_wall_coords[i - 1][STRAIGHT_AHEAD][TOP_LEFT].x;
-      g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT].y +=
-        g_back_wall_coords[i - 1][STRAIGHT_AHEAD][TOP_LEFT].y;
-    }
-    g_back_wall_coords[i][STRAIGHT_AHEAD][BOTTOM_RIGHT].x =
-      GRAPHICS_FRAME_WIDTH - g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT].x;
-    g_back_wall_coords[i][STRAIGHT_AHEAD][BOTTOM_RIGHT].y =
-      GRAPHICS_FRAME_HEIGHT -
-        g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT].y;
-    wall_width = g_back_wall_coords[i][STRAIGHT_AHEAD][BOTTOM_RIGHT].x -
-                   g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT].x;
-    for (j = 1; j <= STRAIGHT_AHEAD; ++j) {
-      g_back_wall_coords[i][STRAIGHT_AHEAD - j][TOP_LEFT] =
-        g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT];
-      g_back_wall_coords[i][STRAIGHT_AHEAD - j][TOP_LEFT].x -= wall_width * j;
-      g_back_wall_coords[i][STRAIGHT_AHEAD - j][BOTTOM_RIGHT] =
-        g_back_wall_coords[i][STRAIGHT_AHEAD][BOTTOM_RIGHT];
-      g_back_wall_coords[i][STRAIGHT_AHEAD - j][BOTTOM_RIGHT].x -= wall_width *
-                                                                     j;
-      g_back_wall_coords[i][STRAIGHT_AHEAD + j][TOP_LEFT] =
-        g_back_wall_coords[i][STRAIGHT_AHEAD][TOP_LEFT];
-      g_back_wall_coords[i][STRAIGHT_AHEAD + j][TOP_LEFT].x += wall_width * j;
-      g_back_wall_coords[i][STRAIGHT_AHEAD + j][BOTTOM_RIGHT] =
-        g_back_wall_coords[i][STRAIGHT_AHEAD][BOTTOM_RIGHT];
-      g_back_wall_coords[i][STRAIGHT_AHEAD + j][BOTTOM_RIGHT].x += wall_width *
-                                                                     j;
-    }
+  finish_maze_generation();
+  reposition_player();
+  reset_minimap();
+  g_maze->seconds = 0;
+  APP_LOG(APP_LOG_LEVEL_INFO,
+          "Maze seed: %lu",
+          (unsigned long) g_maze->seed);  // Replayable via "host/render".
+  update_level_text();
+  update_time_text();
+  if (g_save_timer == NULL) {
+    g_save_timer = app_timer_register(SAVE_DELAY, save_game, NULL);
   }
+  begin_maze_generation(get_new_maze_seed());
+  log_heap_usage("maze swap");
 }
 
 /*******************************************************************************
-   Function: init_maze
+   Function: log_heap_usage
 
-Description: Initializes the global maze struct by setting its width and height
-             according to the current maze size value then setting entrance and
-             exit points and procedurally carving a path between them. Also sets
-             a starting direction, repositions the player, sets the number of
-             seconds spent in the maze to zero, and saves data to persistent
-             storage as a precaution.
+Description: Writes the heap's current usage to the app log, e.g., to check
+             the frame cache's budget (see "FRAME_CACHE_BUDGET") against the
+             platform's memory.
 
-     Inputs: None.
+     Inputs: event - What just happened, for the log message.
 
     Outputs: None.
 *******************************************************************************/
-void init_maze(void) {
-  int8_t i, j, maze_carver_direction;
-  GPoint exit, maze_carver_position;
+void log_heap_usage(const char *const event) {
+  APP_LOG(APP_LOG_LEVEL_DEBUG,
+          "Heap after %s: %u bytes used, %u free",
+          event,
+          (unsigned int) heap_bytes_used(),
+          (unsigned int) heap_bytes_free());
+}
+
+/*******************************************************************************
+   Function: begin_maze_generation
+
+Description: Starts generating the next maze into "g_next_maze" (discarding any
+             maze already in progress there): sets its width and height, colors
+             and entrance and exit points, picks a generator at random, then
+             sets a timer to carry out the generation a slice at a time (see
+             "continue_maze_generation"). Every random choice, here and in
+             "generate_maze", is drawn from the generator's own PRNG, seeded
+             with the maze's seed, so the same seed always yields the same maze
+             (on the watch or, via "host/render", on a PC) and the maze needn't
+             be stored (see "save_game"). The seed's top byte is the maze's max.
+             size (see "MAZE_SEED"); if it's out of range (as with small seeds
+             typed in by hand), level 1's max. size is used instead.
+
+     Inputs: seed - The maze's seed (see "get_new_maze_seed").
 
+    Outputs: None.
+*******************************************************************************/
+void begin_maze_generation(const uint32_t seed) {
+  int8_t side, width, height, max_size = seed >> MAZE_SEED_SIZE_SHIFT;
+  maze_t *const maze = g_next_maze;
+  random_t *const random = &g_maze_generator.random;
+
+  cancel_maze_generation();
+  if (max_size < MIN_MAZE_WIDTH || max_size > MAX_MAZE_WIDTH) {
+    max_size = FIRST_MAX_MAZE_SIZE;
+  }
+  maze->seed = seed;
+  init_random(random, seed);
 #ifdef PBL_COLOR
-  g_maze->floor_color_scheme = rand() % NUM_BACKGROUND_COLOR_SCHEMES;
-  g_maze->wall_color_scheme = rand() % NUM_BACKGROUND_COLOR_SCHEMES;
+  maze->floor_color_scheme = get_random(random) % NUM_BACKGROUND_COLOR_SCHEMES;
+  maze->wall_color_scheme = get_random(random) % NUM_BACKGROUND_COLOR_SCHEMES;
 #endif
 
-  // Determine width and height:
-  g_maze->width = rand() % (MAX_MAZE_WIDTH - MIN_MAZE_WIDTH + 1) +
-                     MIN_MAZE_WIDTH;
-  g_maze->height = rand() % (MAX_MAZE_HEIGHT - MIN_MAZE_HEIGHT + 1) +
-                     MIN_MAZE_HEIGHT;
+  // Determine width and height (all cells starting out "solid"):
+  width = get_random(random) % (max_size - MIN_MAZE_WIDTH + 1) +
+            MIN_MAZE_WIDTH;
+  height = get_random(random) % (max_size - MIN_MAZE_HEIGHT + 1) +
+             MIN_MAZE_HEIGHT;
+  set_maze_size(maze, width, height);
+
+  // Now, set "entrance" and "exit" points (on opposite sides, and at even
+  // coordinates, where the generators' passages meet):
+  side = get_random(random) % NUM_DIRECTIONS;
+  maze->entrance = MAZE_NODE(get_random_edge_point(maze, side, random));
+  g_maze_generator.exit = MAZE_NODE(get_random_edge_point(
+                                      maze,
+                                      get_opposite_direction(side),
+                                      random));
+  set_cell_type(maze, maze->entrance, ENTRANCE);
+  g_maze_generator.maze = maze;
+
+  // Choose a generator:
+  switch (get_random(random) % NUM_MAZE_GENERATORS) {
+    case RECURSIVE_BACKTRACKER_GENERATOR:
+      g_maze_generator.node = maze->entrance;
+      g_maze_generator.walker = g_maze_generator.node;
+      g_maze_generator.stage = BACKTRACK_STAGE;
+      break;
+    default:  // case WILSON_GENERATOR:
+      g_maze_generator.node = GPoint(0, 0);
+      g_maze_generator.walker = g_maze_generator.node;
+      g_maze_generator.steps_left = WILSON_MAX_STEPS_PER_NODE *
+                                      ((maze->width + 1) / 2) *
+                                      ((maze->height + 1) / 2);
+      g_maze_generator.stage = WILSON_WALK_STAGE;
+      break;
+  }
+  g_maze_generation_timer = app_timer_register(MAZE_GENERATION_SLICE_INTERVAL,
+                                               continue_maze_generation,
+                                               NULL);
+}
 
-  // Set all cells to "solid":
-  for (i = 0; i < g_maze->width; ++i) {
-    for (j = 0; j < g_maze->height; ++j) {
-      g_maze->cells[i][j] = SOLID;
-    }
+/*******************************************************************************
+   Function: cancel_maze_generation
+
+Description: Stops generating the next maze (if it's being generated), leaving
+             "g_next_maze" free for other uses (see "generate_chunk").
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void cancel_maze_generation(void) {
+  if (g_maze_generation_timer != NULL) {
+    app_timer_cancel(g_maze_generation_timer);
+    g_maze_generation_timer = NULL;
+  }
+  g_maze_generator.maze = NULL;
+}
+
+/*******************************************************************************
+   Function: continue_maze_generation
+
+Description: Timer callback that carries out one slice of the next maze's
+             generation, setting the timer again if there's more to do.
+
+     Inputs: data - Pointer to additional data (not used).
+
+    Outputs: None.
+*******************************************************************************/
+void continue_maze_generation(void *data) {
+  g_maze_generation_timer = NULL;
+  if (!generate_maze(MAZE_GENERATION_SLICE_STEPS)) {
+    g_maze_generation_timer = app_timer_register(
+                                MAZE_GENERATION_SLICE_INTERVAL,
+                                continue_maze_generation,
+                                NULL);
   }
+}
+
+/*******************************************************************************
+   Function: finish_maze_generation
+
+Description: Finishes generating the next maze (see "begin_maze_generation")
+             and swaps it in as the current maze, clearing the frame cache,
+             updating the backdrop and wall texture, and setting a starting
+             direction.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void finish_maze_generation(void) {
+  maze_t *const previous_maze = g_maze;
+
+  generate_maze(MAZE_GENERATION_NO_STEP_LIMIT);
+  g_maze = g_next_maze;
+  g_next_maze = previous_maze;
+  g_maze_generator.maze = NULL;
+  g_maze_id++;
+  clear_frame_cache();  // Views of the previous maze are no longer valid.
+  g_scene_dirty = true;
+  update_backdrop();
+  update_wall_texture();
+  set_maze_starting_direction();
+}
+
+/*******************************************************************************
+   Function: get_new_maze_seed
+
+Description: Picks a seed for a new maze, whose max. size is set by the
+             player's level (see "get_max_maze_size").
+
+     Inputs: None.
+
+    Outputs: The new maze's seed.
+*******************************************************************************/
+uint32_t get_new_maze_seed(void) {
+  return MAZE_SEED(get_random(&g_random), get_max_maze_size());
+}
+
+/*******************************************************************************
+   Function: get_random_edge_point
+
+Description: Picks a random cell within a quarter of a maze's width or height
+             of a given side. (Its coordinates are drawn in turn, so the result
+             doesn't depend on the compiler's order of evaluation.)
+
+     Inputs: maze   - Pointer to the maze.
+             side   - Direction of the side.
+             random - Pointer to the PRNG to draw from.
 
-  // Now, set "entrance" and "exit" points and carve a path between them:
-  switch (rand() % NUM_DIRECTIONS) {
+    Outputs: The cell's coordinates.
+*******************************************************************************/
+GPoint get_random_edge_point(const maze_t *const maze,
+                             const int8_t side,
+                             random_t *const random) {
+  const uint32_t first = get_random(random),
+                 second = get_random(random);
+
+  switch (side) {
     case NORTH:
-      maze_carver_position = RANDOM_POINT_NORTH;
-      exit = RANDOM_POINT_SOUTH;
-      break;
+      return GPoint(first % maze->width, second % (maze->height / 4));
     case SOUTH:
-      maze_carver_position = RANDOM_POINT_SOUTH;
-      exit = RANDOM_POINT_NORTH;
-      break;
+      return GPoint(first % maze->width,
+                    maze->height - (1 + second % (maze->height / 4)));
     case EAST:
-      maze_carver_position = RANDOM_POINT_EAST;
-      exit = RANDOM_POINT_WEST;
-      break;
+      return GPoint(maze->width - (1 + first % (maze->width / 4)),
+                    second % maze->height);
     default:  // case WEST:
-      maze_carver_position = RANDOM_POINT_WEST;
-      exit = RANDOM_POINT_EAST;
-      break;
+      return GPoint(first % (maze->width / 4), second % maze->height);
   }
-  g_maze->cells[maze_carver_position.x][maze_carver_position.y] = ENTRANCE;
-  g_maze->entrance = maze_carver_position;
-  g_maze->cells[exit.x][exit.y] = EXIT;
-  maze_carver_direction = rand() % NUM_DIRECTIONS;
-  while (!gpoint_equal(&maze_carver_position, &exit)) {
-    if (get_cell_type(maze_carver_position) != ENTRANCE) {
-      g_maze->cells[maze_carver_position.x][maze_carver_position.y] = EMPTY;
-    }
-    switch(maze_carver_direction) {
-      case NORTH:
-        if (maze_carver_position.y > 0) {
-          maze_carver_position.y--;
+}
+
+/*******************************************************************************
+   Function: generate_maze
+
+Description: Carries out up to a given number of steps of the next maze's
+             generation, picking up where the last call left off. Both
+             generators produce perfect mazes (i.e., with exactly one path
+             between any two open cells), carving passages between cells at
+             even coordinates ("nodes"):
+
+             - The recursive backtracker carves depth-first, each step either
+               carving a passage from the current node to a random unvisited
+               neighbor (and moving there) or, if there's none, backtracking
+               to the node it came from. Rather than keep a stack, each node
+               notes the direction back to its parent in "g_walk_directions"
+               (2 bits per node). Once back at the root with nowhere left to
+               go, the remaining nodes are scanned in order for any others to
+               carve onward from. Each node is entered and left exactly once,
+               so it takes O(cells) steps.
+             - Wilson's algorithm picks uniformly among all possible mazes
+               (the backtracker favors long corridors). From each node not yet
+               in the maze, a random walk is taken until it reaches the maze,
+               noting the direction last left each node; the walk is then
+               retraced from its start, so any loops it made are erased, and
+               carved into the maze. A random walk has no upper bound on its
+               length, so the walks share a budget of
+               "WILSON_MAX_STEPS_PER_NODE" steps per node. Should it run out
+               (which is rare), the nodes still outside the maze are joined to
+               it by the backtracker instead, so Wilson's also always takes
+               O(cells) steps.
+
+     Inputs: max_steps - Max. no. of steps to carry out.
+
+    Outputs: Returns "true" if the maze is finished.
+*******************************************************************************/
+bool generate_maze(const int32_t max_steps) {
+  int8_t num_directions, direction, directions[NUM_DIRECTIONS];
+  int32_t steps;
+  maze_generator_t *const generator = &g_maze_generator;
+  maze_t *const maze = generator->maze;
+
+  for (steps = 0;
+       steps < max_steps && generator->stage != GENERATED_STAGE;
+       ++steps) {
+    switch (generator->stage) {
+      case WILSON_WALK_STAGE:
+        if (!MAZE_CELL_IS_SOLID(maze, generator->walker)) {  // Reached it.
+          generator->walker = generator->node;
+          generator->stage = WILSON_RETRACE_STAGE;
+        } else if (generator->steps_left-- <= 0) {
+          // Out of steps, so let the backtracker finish the job, starting
+          // from every node already in the maze in turn:
+          generator->node = GPoint(0, 0);
+          generator->walker = generator->node;
+          generator->stage = BACKTRACK_STAGE;
+        } else {
+          num_directions = get_node_directions(maze,
+                                               generator->walker,
+                                               false,
+                                               directions);
+          direction = directions[get_random(&generator->random) %
+                                 num_directions];
+          set_walk_direction(generator->walker, direction);
+          generator->walker = get_cell_farther_away(generator->walker,
+                                                    direction,
+                                                    2);
         }
         break;
-      case SOUTH:
-        if (maze_carver_position.y < g_maze->height - 1) {
-          maze_carver_position.y++;
+      case WILSON_RETRACE_STAGE:
+        if (MAZE_CELL_IS_SOLID(maze, generator->walker)) {
+          direction = WALK_DIRECTION(generator->walker);
+          carve_passage(maze, generator->walker, direction);
+          generator->walker = get_cell_farther_away(generator->walker,
+                                                    direction,
+                                                    2);
+          break;
         }
+
+        // Move on to the next node (if any):
+        generator->stage = advance_maze_generator_node() ? WILSON_WALK_STAGE :
+                                                           GENERATED_STAGE;
         break;
-      case EAST:
-        if (maze_carver_position.x < g_maze->width - 1) {
-          maze_carver_position.x++;
+      default:  // case BACKTRACK_STAGE:
+        if (!MAZE_CELL_IS_SOLID(maze, generator->walker)) {
+          num_directions = get_node_directions(maze,
+                                               generator->walker,
+                                               true,
+                                               directions);
+          if (num_directions > 0) {  // Carve onward.
+            direction = directions[get_random(&generator->random) %
+                                   num_directions];
+            generator->walker = get_cell_farther_away(generator->walker,
+                                                      direction,
+                                                      2);
+            direction = get_opposite_direction(direction);
+            carve_passage(maze, generator->walker, direction);
+            set_walk_direction(generator->walker, direction);
+            break;
+          }
+          if (!gpoint_equal(&generator->walker, &generator->node)) {
+            generator->walker = get_cell_farther_away(  // Backtrack.
+                                  generator->walker,
+                                  WALK_DIRECTION(generator->walker),
+                                  2);
+            break;
+          }
         }
-        break;
-      default:  // case WEST:
-        if (maze_carver_position.x > 0) {
-          maze_carver_position.x--;
+
+        // Done with the root (or it isn't in the maze yet), so move on to the
+        // next node (if any):
+        if (!advance_maze_generator_node()) {
+          generator->stage = GENERATED_STAGE;
         }
         break;
     }
-    if (rand() % 2) {  // 50% chance of turning.
-      maze_carver_direction = rand() % NUM_DIRECTIONS;
+  }
+  if (generator->stage != GENERATED_STAGE) {
+    return false;
+  }
+  set_cell_type(maze, generator->exit, EXIT);
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: get_node_directions
+
+Description: Determines in which directions a given node has a neighboring node
+             within a maze's bounds (two cells away, with a wall cell between
+             them).
+
+     Inputs: maze           - Pointer to the maze.
+             node           - Coordinates of the node.
+             unvisited_only - If "true", only neighbors that aren't yet part of
+                              the maze (i.e., are still solid) are counted.
+             directions     - Array in which to store the directions found.
+
+    Outputs: The number of directions found.
+*******************************************************************************/
+int8_t get_node_directions(const maze_t *const maze,
+                           const GPoint node,
+                           const bool unvisited_only,
+                           int8_t directions[NUM_DIRECTIONS]) {
+  int8_t direction, num_directions = 0;
+  GPoint neighbor;
+
+  for (direction = 0; direction < NUM_DIRECTIONS; ++direction) {
+    neighbor = get_cell_farther_away(node, direction, 2);
+    if (neighbor.x >= 0 && neighbor.x < maze->width &&
+        neighbor.y >= 0 && neighbor.y < maze->height &&
+        (!unvisited_only || MAZE_CELL_IS_SOLID(maze, neighbor))) {
+      directions[num_directions++] = direction;
     }
   }
-  set_maze_starting_direction();
-  reposition_player();
-  g_maze->seconds = 0;
-  persist_write_data(PLAYER_STORAGE_KEY, g_player, sizeof(player_t));
-  persist_write_data(MAZE_STORAGE_KEY, g_maze, sizeof(maze_t));
+
+  return num_directions;
 }
 
 /*******************************************************************************
-   Function: set_maze_starting_direction
+   Function: carve_passage
 
-Description: Finds a viable starting direction (i.e., not facing a wall) for the
-             current maze. (There should always be a viable direction, but if
-             there isn't, the last direction checked will be selected.)
+Description: Adds a node to a maze by opening it and the wall cell between it
+             and a neighboring node (which is, or soon will be, open).
+
+     Inputs: maze      - Pointer to the maze.
+             node      - Coordinates of the node.
+             direction - Direction of the neighboring node to connect it to.
+
+    Outputs: None.
+*******************************************************************************/
+void carve_passage(maze_t *const maze,
+                   const GPoint node,
+                   const int8_t direction) {
+  const GPoint wall = get_cell_farther_away(node, direction, 1);
+
+  set_cell_type(maze, node, EMPTY);
+  set_cell_type(maze, wall, EMPTY);
+}
+
+/*******************************************************************************
+   Function: advance_maze_generator_node
+
+Description: Moves the maze generator's "node" (and its "walker") on to the
+             next node of the maze being generated, scanning column by column.
 
      Inputs: None.
 
-    Outputs: Value representing the selected starting direction.
+    Outputs: Returns "false" if there are no more nodes.
 *******************************************************************************/
-int8_t set_maze_starting_direction(void) {
-  int8_t i;
-  bool checked_direction[NUM_DIRECTIONS];
+bool advance_maze_generator_node(void) {
+  maze_generator_t *const generator = &g_maze_generator;
 
-  for (i = 0; i < NUM_DIRECTIONS; ++i) {
-    checked_direction[i] = false;
+  generator->node.y += 2;
+  if (generator->node.y >= generator->maze->height) {
+    generator->node.y = 0;
+    generator->node.x += 2;
   }
-  do {
-    g_maze->starting_direction = rand() % NUM_DIRECTIONS;
-    checked_direction[g_maze->starting_direction] = true;
-  }while (is_solid(get_cell_farther_away(g_maze->entrance,
-                                         g_maze->starting_direction,
-                                         1)) &&
-          !(checked_direction[NORTH] &&
-            checked_direction[SOUTH] &&
-            checked_direction[EAST] &&
-            checked_direction[WEST]));
+  generator->walker = generator->node;
 
-  return g_maze->starting_direction;
+  return generator->node.x < generator->maze->width;
 }
 
 /*******************************************************************************
-   Function: draw_scene
+   Function: set_walk_direction
 
-Description: Draws a (simplistic) 3D scene based on the player's current
-             position, direction, and visibility depth.
+Description: Notes the direction last taken from a given node by Wilson's random
+             walk, or back toward the backtracker's root (see "generate_maze").
 
-     Inputs: layer - Pointer to the relevant layer.
-             ctx   - Pointer to the relevant graphics context.
+     Inputs: node      - Coordinates of the node.
+             direction - The direction.
 
     Outputs: None.
 *******************************************************************************/
-void draw_scene(Layer *layer, GContext *ctx) {
-  int8_t i, depth;
-  GPoint cell_coords, cell_coords2;
+void set_walk_direction(const GPoint node, const int8_t direction) {
+  const uint16_t index = WALK_DIRECTION_INDEX(node);
+  uint8_t *const byte = &g_walk_directions[index / CELLS_PER_BYTE];
 
-  // First, draw a black background:
-  graphics_context_set_fill_color(ctx, GColorBlack);
-  graphics_fill_rect(ctx,
-                     layer_get_bounds(layer),
-                     NO_CORNER_RADIUS,
-                     GCornerNone);
+  *byte = (*byte & ~(CELL_TYPE_MASK << CELL_SHIFT(index))) |
+            (direction << CELL_SHIFT(index));
+}
 
-  // Next, draw the floor, ceiling, and walls of the maze:
-  draw_floor_and_ceiling(ctx);
-  for (depth = MAX_VISIBILITY_DEPTH - 1; depth >= 0; --depth) {
-    // Draw the walls straight ahead at the current depth:
-    cell_coords = get_cell_farther_away(g_player->position,
-                                        g_player->direction,
-                                        depth);
-    if (out_of_bounds(cell_coords)) {
-      continue;
-    }
-    draw_cell_contents(ctx, cell_coords, depth, STRAIGHT_AHEAD);
+/*******************************************************************************
+   Function: save_game
 
-    // Now, draw all cells to the left and right at the same depth:
-    for (i = 1; i <= depth + 1; ++i) {
-      cell_coords2 = get_cell_to_the_left(cell_coords,
-                                          g_player->direction,
-                                          i);
-      draw_cell_contents(ctx, cell_coords2, depth, STRAIGHT_AHEAD - i);
-      cell_coords2 = get_cell_to_the_right(cell_coords,
-                                           g_player->direction,
-                                           i);
-      draw_cell_contents(ctx, cell_coords2, depth, STRAIGHT_AHEAD + i);
-    }
+Description: Saves the player, the current maze, the minimap, endless mode's
+             state and the render engine to persistent storage. (Normally
+             called via a timer, so flash writes don't hold up level
+             transitions.) Only the maze's seed and clock are stored, a few
+             bytes in place of its ~1 KB of cells, as it's regenerated from
+             its seed on loading (see "init").
+
+     Inputs: data - Pointer to additional data (not used).
+
+    Outputs: None.
+*******************************************************************************/
+void save_game(void *data) {
+  const saved_maze_t saved_maze = {
+    .seed = g_maze->seed,
+    .seconds = g_maze->seconds,
+  };
+
+  g_save_timer = NULL;
+  persist_write_data(PLAYER_STORAGE_KEY, g_player, sizeof(player_t));
+  persist_write_data(MAZE_STORAGE_KEY, &saved_maze, sizeof(saved_maze_t));
+  persist_write_chunks(MINIMAP_STORAGE_KEY, &g_minimap, sizeof(minimap_t));
+  persist_write_data(ENDLESS_STORAGE_KEY, &g_endless, sizeof(endless_t));
+  persist_write_int(RENDER_ENGINE_STORAGE_KEY, g_render_engine);
+}
+
+/*******************************************************************************
+   Function: persist_write_chunks
+
+Description: Writes data too large for a single key to persistent storage,
+             split across consecutive keys ("NUM_STORAGE_CHUNKS(size)" of them)
+             of up to "PERSIST_DATA_MAX_LENGTH" bytes each.
+
+     Inputs: first_key - Key of the first chunk.
+             data      - Pointer to the data.
+             size      - Size of the data, in bytes.
+
+    Outputs: None.
+*******************************************************************************/
+void persist_write_chunks(const uint32_t first_key,
+                          const void *const data,
+                          const size_t size) {
+  size_t offset;
+  uint32_t key = first_key;
+
+  for (offset = 0; offset < size; offset += PERSIST_DATA_MAX_LENGTH) {
+    persist_write_data(key++,
+                       (const uint8_t *) data + offset,
+                       size - offset < PERSIST_DATA_MAX_LENGTH ?
+                         size - offset                         :
+                         PERSIST_DATA_MAX_LENGTH);
+  }
+}
+
+/*******************************************************************************
+   Function: persist_read_chunks
+
+Description: Reads data written by "persist_write_chunks" back from persistent
+             storage.
+
+     Inputs: first_key - Key of the first chunk.
+             data      - Pointer to where the data should go.
+             size      - Size of the data, in bytes.
+
+    Outputs: Returns "false" if any chunk is missing (in which case the data
+             may be partially overwritten).
+*******************************************************************************/
+bool persist_read_chunks(const uint32_t first_key,
+                         void *const data,
+                         const size_t size) {
+  size_t offset;
+  uint32_t key = first_key;
+
+  for (offset = 0; offset < size; offset += PERSIST_DATA_MAX_LENGTH) {
+    if (!persist_exists(key)) {
+      return false;
+    }
+    persist_read_data(key++,
+                      (uint8_t *) data + offset,
+                      size - offset < PERSIST_DATA_MAX_LENGTH ?
+                        size - offset                         :
+                        PERSIST_DATA_MAX_LENGTH);
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: get_max_maze_size
+
+Description: Returns the max. no. of cells per side of a new maze, which starts
+             at "FIRST_MAX_MAZE_SIZE" and grows by one every
+             "LEVELS_PER_MAZE_SIZE_INCREASE" levels, up to "MAX_MAZE_WIDTH".
+             (The next maze is generated while the current one is played, so
+             it's sized by the current level.)
+
+     Inputs: None.
+
+    Outputs: Max. no. of cells per side.
+*******************************************************************************/
+int8_t get_max_maze_size(void) {
+  const int16_t size = FIRST_MAX_MAZE_SIZE + (g_player->level - 1) /
+                                               LEVELS_PER_MAZE_SIZE_INCREASE;
+
+  return size < MAX_MAZE_WIDTH ? size : MAX_MAZE_WIDTH;
+}
+
+/*******************************************************************************
+   Function: set_endless_mode
+
+Description: Moves the player into or out of the endless labyrinth: an unbounded
+             grid of chunks, each generated from a world seed and its own
+             coordinates when a view first reaches it (see "get_chunk"), so it
+             needn't be stored. Cell lookups ("get_cell_type", "out_of_bounds")
+             follow the player, so movement and rendering work unchanged. The
+             current maze is set aside (with the player's place in it) and
+             resumed on leaving. Meanwhile, "g_next_maze" serves as scratch
+             space for generating chunks, so the next maze's generation is put
+             off until then.
+
+     Inputs: enabled - If "true", the player enters the endless labyrinth.
+
+    Outputs: None.
+*******************************************************************************/
+void set_endless_mode(const bool enabled) {
+  if (enabled == g_endless.enabled) {
+    return;
+  }
+  if (enabled) {
+    cancel_maze_generation();
+    g_endless.maze_position = g_player->position;
+    g_endless.maze_direction = g_player->direction;
+    g_endless.enabled = true;
+    reset_endless_world();
+  } else {
+    g_endless.enabled = false;
+    clear_chunks();
+    g_player->position = g_endless.maze_position;
+    g_player->direction = g_endless.maze_direction;
+    g_maze_id++;
+    clear_frame_cache();
+    update_compass();
+    begin_maze_generation(get_new_maze_seed());
+  }
+  layer_set_hidden(g_minimap_layer, !g_minimap.enabled || g_endless.enabled);
+  g_scene_dirty = true;
+  layer_mark_dirty(g_scene_layer);
+}
+
+/*******************************************************************************
+   Function: reset_endless_world
+
+Description: Starts a new endless labyrinth, with a new world seed, placing the
+             player at its origin (which, like every cell at even coordinates,
+             is always open).
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void reset_endless_world(void) {
+  g_endless.seed = get_random(&g_random);
+  clear_chunks();
+  g_maze_id++;
+  clear_frame_cache();
+  g_player->position = GPointZero;
+  g_player->direction = NORTH;
+  while (is_solid(get_cell_farther_away(g_player->position,
+                                        g_player->direction,
+                                        1))) {
+    g_player->direction = (g_player->direction + 1) % NUM_DIRECTIONS;
+  }
+  update_compass();
+  g_scene_dirty = true;
+  layer_mark_dirty(g_scene_layer);
+}
+
+/*******************************************************************************
+   Function: clear_chunks
+
+Description: Discards every resident chunk of the endless labyrinth.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void clear_chunks(void) {
+  int8_t i;
+
+  for (i = 0; i < MAX_RESIDENT_CHUNKS; ++i) {
+    g_chunks[i].loaded = false;
+  }
+  g_last_chunk = NULL;
+}
+
+/*******************************************************************************
+   Function: get_chunk
+
+Description: Returns a given chunk of the endless labyrinth, generating it if it
+             isn't resident. Only "MAX_RESIDENT_CHUNKS" chunks are kept, the
+             least recently used giving way to new ones, so memory use is
+             constant however far the player goes. (A view spans at most six
+             chunks, and a chunk that's been discarded is simply generated
+             again, identically, if it's seen again.)
+
+     Inputs: coords - Coordinates of the chunk (in chunks).
+
+    Outputs: Pointer to the chunk.
+*******************************************************************************/
+chunk_t *get_chunk(const GPoint coords) {
+  int8_t i;
+  chunk_t *chunk = g_last_chunk, *oldest_chunk = NULL;
+
+  if (chunk != NULL && gpoint_equal(&chunk->coords, &coords)) {
+    return chunk;  // Most lookups stay within the same chunk.
+  }
+  for (i = 0, chunk = NULL; i < MAX_RESIDENT_CHUNKS && chunk == NULL; ++i) {
+    if (!g_chunks[i].loaded) {
+      oldest_chunk = &g_chunks[i];
+    } else if (gpoint_equal(&g_chunks[i].coords, &coords)) {
+      chunk = &g_chunks[i];
+    } else if (oldest_chunk == NULL ||
+               (oldest_chunk->loaded &&
+                g_chunks[i].last_used < oldest_chunk->last_used)) {
+      oldest_chunk = &g_chunks[i];
+    }
+  }
+  if (chunk == NULL) {
+    chunk = oldest_chunk;
+    generate_chunk(chunk, coords);
+  }
+  chunk->last_used = ++g_chunk_clock;
+  g_last_chunk = chunk;
+
+  return chunk;
+}
+
+/*******************************************************************************
+   Function: generate_chunk
+
+Description: Generates a given chunk of the endless labyrinth, deterministically
+             from its seed (see "get_chunk_seed"). All but the last row and
+             column of the chunk are a perfect maze made by the recursive
+             backtracker (see "generate_maze"), built in "g_next_maze" and
+             copied over. The last row and column are the chunk's borders with
+             its neighbors to the south and east: each is opened in at least
+             one place (and, now and then, a few more), so every chunk joins
+             its neighbors and the whole labyrinth is connected.
+
+     Inputs: chunk  - Pointer to where the chunk should go.
+             coords - Coordinates of the chunk (in chunks).
+
+    Outputs: None.
+*******************************************************************************/
+void generate_chunk(chunk_t *const chunk, const GPoint coords) {
+  int8_t i, side, first_opening;
+  maze_t *const maze = g_next_maze;
+  maze_generator_t *const generator = &g_maze_generator;
+
+  init_random(&generator->random, get_chunk_seed(coords));
+  set_maze_size(maze, CHUNK_SIZE, CHUNK_SIZE);  // All "solid".
+  maze->width = CHUNK_SIZE - 1;  // (The borders are opened below.)
+  maze->height = CHUNK_SIZE - 1;
+  generator->maze = maze;
+  generator->node.x = get_random(&generator->random) % maze->width;
+  generator->node.y = get_random(&generator->random) % maze->height;
+  generator->node = MAZE_NODE(generator->node);
+  generator->walker = generator->node;
+  generator->exit = generator->node;
+  generator->stage = BACKTRACK_STAGE;
+  set_cell_type(maze, generator->node, EMPTY);
+  generate_maze(MAZE_GENERATION_NO_STEP_LIMIT);
+  set_cell_type(maze, generator->exit, EMPTY);  // There are no exits.
+  generator->maze = NULL;
+
+  // Open the east and south borders:
+  for (side = 0; side < 2; ++side) {
+    first_opening = get_random(&generator->random) % (CHUNK_SIZE / 2);
+    for (i = 0; i < CHUNK_SIZE / 2; ++i) {
+      if (i == first_opening ||
+          get_random(&generator->random) % CHUNK_EXTRA_OPENING_ODDS == 0) {
+        set_cell_type(maze,
+                      side == 0 ? GPoint(CHUNK_SIZE - 1, 2 * i) :
+                                  GPoint(2 * i, CHUNK_SIZE - 1),
+                      EMPTY);
+      }
+    }
+  }
+  memcpy(chunk->cells, maze->cells, sizeof(chunk->cells));  // Same layout.
+  chunk->coords = coords;
+  chunk->loaded = true;
+}
+
+/*******************************************************************************
+   Function: get_chunk_seed
+
+Description: Derives the random seed of a given chunk of the endless labyrinth
+             from the world seed and the chunk's coordinates.
+
+     Inputs: coords - Coordinates of the chunk (in chunks).
+
+    Outputs: The chunk's seed.
+*******************************************************************************/
+uint32_t get_chunk_seed(const GPoint coords) {
+  return mix_bits(g_endless.seed ^ ((uint32_t) (uint16_t) coords.x << 16 |
+                                    (uint16_t) coords.y));
+}
+
+/*******************************************************************************
+   Function: init_random
+
+Description: Seeds a PRNG (see "get_random"). The seed is spread over the
+             generator's 128 bits of state by SplitMix32-style hashing of
+             successive multiples of the golden ratio, which also keeps the
+             state from being all zeros (which xoshiro can't leave).
+
+     Inputs: random - Pointer to the PRNG.
+             seed   - Any 32-bit value.
+
+    Outputs: None.
+*******************************************************************************/
+void init_random(random_t *const random, uint32_t seed) {
+  int8_t i;
+
+  for (i = 0; i < 4; ++i) {
+    seed += 0x9E3779B9;  // 2^32 divided by the golden ratio.
+    random->state[i] = mix_bits(seed);
+  }
+}
+
+/*******************************************************************************
+   Function: get_random
+
+Description: Draws the next value from a PRNG, using xoshiro128** (by Blackman
+             and Vigna): small, fast and of good quality, and since it's
+             self-contained (unlike "rand", whose algorithm and state vary from
+             one C library to another), its sequences are the same on every
+             platform.
+
+     Inputs: random - Pointer to the PRNG (see "init_random").
+
+    Outputs: A pseudorandom 32-bit value.
+*******************************************************************************/
+uint32_t get_random(random_t *const random) {
+  uint32_t *const s = random->state;
+  const uint32_t result = ROTATE_LEFT(s[1] * 5, 7) * 9,
+                 t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = ROTATE_LEFT(s[3], 11);
+
+  return result;
+}
+
+/*******************************************************************************
+   Function: mix_bits
+
+Description: Mixes every bit of a 32-bit value into every other (as in
+             MurmurHash3's finalizer), so similar values give unrelated
+             results. (Distinct values give distinct results, and only zero
+             gives zero.)
+
+     Inputs: value - The value to mix.
+
+    Outputs: The mixed value.
+*******************************************************************************/
+uint32_t mix_bits(uint32_t value) {
+  value ^= value >> 16;
+  value *= 0x85EBCA6B;
+  value ^= value >> 13;
+  value *= 0xC2B2AE35;
+  value ^= value >> 16;
+
+  return value;
+}
+
+/*******************************************************************************
+   Function: set_maze_starting_direction
+
+Description: Finds a viable starting direction (i.e., not facing a wall) for the
+             current maze, drawing from the PRNG that generated it (so it, too,
+             follows from the seed). (There should always be a viable
+             direction, but if there isn't, the last direction checked will be
+             selected.)
+
+     Inputs: None.
+
+    Outputs: Value representing the selected starting direction.
+*******************************************************************************/
+int8_t set_maze_starting_direction(void) {
+  int8_t i;
+  bool checked_direction[NUM_DIRECTIONS];
+
+  for (i = 0; i < NUM_DIRECTIONS; ++i) {
+    checked_direction[i] = false;
+  }
+  do {
+    g_maze->starting_direction = get_random(&g_maze_generator.random) %
+                                   NUM_DIRECTIONS;
+    checked_direction[g_maze->starting_direction] = true;
+  }while (is_solid(get_cell_farther_away(g_maze->entrance,
+                                         g_maze->starting_direction,
+                                         1)) &&
+          !(checked_direction[NORTH] &&
+            checked_direction[SOUTH] &&
+            checked_direction[EAST] &&
+            checked_direction[WEST]));
+
+  return g_maze->starting_direction;
+}
+
+/*******************************************************************************
+   Function: draw_scene
+
+Description: Draws a (simplistic) 3D scene based on the player's current
+             position, direction, and visibility depth.
+
+     Inputs: layer - Pointer to the relevant layer.
+             ctx   - Pointer to the relevant graphics context.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_scene(Layer *layer, GContext *ctx) {
+  int8_t depth, num_depths;
+  bool frame_buffer_captured, rapid_input;
+  uint32_t start_time, frame_time;
+  cached_frame_t *frame;
+
+  start_time = get_time_in_ms();
+  DRAW_STATS_BEGIN_FRAME();
+
+  // If the view hasn't changed since it was last drawn (e.g., on a clock tick),
+  // or was drawn recently, simply restore it:
+  frame = g_scene_dirty ? find_cached_frame() : g_shown_frame;
+  if (restore_cached_frame(layer, ctx, frame)) {
+    g_scene_dirty = false;
+    DRAW_STATS_END_FRAME(get_time_in_ms() - start_time, true);
+
+    return;
+  }
+
+  // Note whether this frame follows closely on the last one actually rendered
+  // (e.g., because the player is holding a button):
+  rapid_input = start_time - g_last_frame_time < QUALITY_RESTORE_DELAY;
+  g_last_frame_time = start_time;
+
+  // First, draw the floor and ceiling over a black background:
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  if (g_backdrop != NULL) {
+    graphics_fill_rect(ctx,
+                       GRect(0, 0, SCREEN_WIDTH, STATUS_BAR_HEIGHT),
+                       NO_CORNER_RADIUS,
+                       GCornerNone);
+    graphics_draw_bitmap_in_rect(ctx, g_backdrop, BACKDROP_FRAME);
+    frame_buffer_captured = capture_frame_buffer(ctx);
+  } else {  // Fall back to drawing them from scratch.
+    graphics_fill_rect(ctx,
+                       layer_get_bounds(layer),
+                       NO_CORNER_RADIUS,
+                       GCornerNone);
+    frame_buffer_captured = capture_frame_buffer(ctx);
+    draw_floor_and_ceiling(ctx, STATUS_BAR_HEIGHT);
+  }
+
+  // Next, draw the walls of the maze:
+  memset(g_column_coverage, 0, sizeof(g_column_coverage));
+  memset(g_new_column_coverage, 0, sizeof(g_new_column_coverage));
+  num_depths = g_render_quality >= NEAR_WALLS_QUALITY ?
+                 REDUCED_VISIBILITY_DEPTH : MAX_VISIBILITY_DEPTH;
+#ifdef RAYCASTING_ENGINE_ENABLED
+  if (g_render_engine == RAYCASTING_ENGINE) {
+    draw_raycast_scene(ctx, get_direction_angle(g_player->direction));
+  } else
+#endif
+  if (frame_buffer_captured) {
+    // Front to back, skipping anything hidden behind nearer walls:
+    for (depth = 0; depth < num_depths; ++depth) {
+      if (!draw_cells_at_depth(ctx, depth) || update_column_coverage()) {
+        break;  // The rest of the scene is out of bounds or fully hidden.
+      }
+    }
+  } else {
+    // Back to front, since the graphics context can't be clipped per column:
+    for (depth = num_depths - 1; depth >= 0; --depth) {
+      draw_cells_at_depth(ctx, depth);
+    }
+  }
+  if (frame_buffer_captured) {
+    cache_frame();
+    g_scene_dirty = false;
+  }
+  release_frame_buffer(ctx);
+  frame_time = get_time_in_ms() - start_time;
+  update_render_quality(rapid_input, frame_time);
+  DRAW_STATS_END_FRAME(frame_time, false);
+}
+
+/*******************************************************************************
+   Function: update_render_quality
+
+Description: Lowers the render quality by one level if a frame drawn during
+             rapid input took longer than "FRAME_TIME_BUDGET", and (re)starts
+             the timer that restores full quality once input settles.
+
+     Inputs: rapid_input - Whether the frame closely followed the previous one.
+             frame_time  - Time taken to draw the frame, in milliseconds.
+
+    Outputs: None.
+*******************************************************************************/
+void update_render_quality(const bool rapid_input, const uint32_t frame_time) {
+  if (rapid_input &&
+      frame_time > FRAME_TIME_BUDGET &&
+      g_render_quality < NUM_RENDER_QUALITY_LEVELS - 1) {
+    g_render_quality++;
+  }
+  if (g_render_quality != FULL_QUALITY) {
+    if (g_quality_timer == NULL) {
+      g_quality_timer = app_timer_register(QUALITY_RESTORE_DELAY,
+                                           restore_render_quality,
+                                           NULL);
+    } else {
+      app_timer_reschedule(g_quality_timer, QUALITY_RESTORE_DELAY);
+    }
+  }
+}
+
+/*******************************************************************************
+   Function: restore_render_quality
+
+Description: Timer callback that redraws the 3D view at full quality once no
+             frame has been drawn for "QUALITY_RESTORE_DELAY" milliseconds.
+             (That redraw isn't "rapid", so it can't lower the quality again.)
+
+     Inputs: data - Unused.
+
+    Outputs: None.
+*******************************************************************************/
+void restore_render_quality(void *data) {
+  g_quality_timer = NULL;
+  g_render_quality = FULL_QUALITY;
+  g_scene_dirty = true;
+  layer_mark_dirty(g_scene_layer);
+}
+
+/*******************************************************************************
+   Function: get_time_in_ms
+
+Description: Returns the current time in milliseconds (wrapping around every
+             49 days or so, which is harmless for measuring short intervals).
+
+     Inputs: None.
+
+    Outputs: The current time, in milliseconds.
+*******************************************************************************/
+uint32_t get_time_in_ms(void) {
+  time_t seconds;
+  uint16_t milliseconds;
+
+  time_ms(&seconds, &milliseconds);
+
+  return (uint32_t) seconds * 1000 + milliseconds;
+}
+
+#ifdef DRAW_STATS
+/*******************************************************************************
+   Function: begin_draw_stats_frame
+
+Description: Clears the counters in the "g_draw_stats" ring buffer's current
+             slot (overwriting its oldest frame once the buffer is full), so
+             the drawing calls of a new frame can be counted.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void begin_draw_stats_frame(void) {
+  memset(&g_draw_stats[g_draw_stats_index], 0, sizeof(draw_stats_t));
+}
+
+/*******************************************************************************
+   Function: end_draw_stats_frame
+
+Description: Records the duration of the frame being counted and moves on to
+             the next slot of the "g_draw_stats" ring buffer. (Drawing done
+             outside "draw_scene" is counted in the next slot, too, but that's
+             cleared before the next frame begins.)
+
+     Inputs: frame_time - Time taken to draw the frame, in milliseconds.
+             cached     - Whether the frame was restored from the frame cache.
+
+    Outputs: None.
+*******************************************************************************/
+void end_draw_stats_frame(const uint32_t frame_time, const bool cached) {
+  g_draw_stats[g_draw_stats_index].frame_time = frame_time;
+  g_draw_stats[g_draw_stats_index].cached = cached;
+  g_draw_stats_index = (g_draw_stats_index + 1) % DRAW_STATS_NUM_FRAMES;
+  if (g_draw_stats_num_frames < DRAW_STATS_NUM_FRAMES) {
+    g_draw_stats_num_frames++;
+  }
+}
+
+/*******************************************************************************
+   Function: log_draw_stats
+
+Description: Writes the drawing counts of every frame in the "g_draw_stats"
+             ring buffer to the app log (oldest first), followed by the
+             average and worst frame times.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void log_draw_stats(void) {
+  uint8_t i;
+  uint32_t total_time = 0, max_time = 0;
+  const draw_stats_t *stats;
+
+  APP_LOG(APP_LOG_LEVEL_DEBUG,
+          "Draw stats (oldest first): ms, pixel/line/rect/circle/bitmap "
+          "calls, stroke/fill color changes, pixels written directly");
+  for (i = 0; i < g_draw_stats_num_frames; ++i) {
+    stats = &g_draw_stats[(g_draw_stats_index + DRAW_STATS_NUM_FRAMES -
+                           g_draw_stats_num_frames + i) %
+                          DRAW_STATS_NUM_FRAMES];
+    APP_LOG(APP_LOG_LEVEL_DEBUG,
+            "%u%s: %u/%u/%u/%u/%u, %u/%u, %u",
+            (unsigned int) stats->frame_time,
+            stats->cached ? " (cached)" : "",
+            (unsigned int) stats->pixel_calls,
+            (unsigned int) stats->line_calls,
+            (unsigned int) stats->rect_calls,
+            (unsigned int) stats->circle_calls,
+            (unsigned int) stats->bitmap_calls,
+            (unsigned int) stats->stroke_color_calls,
+            (unsigned int) stats->fill_color_calls,
+            (unsigned int) stats->direct_pixels);
+    total_time += stats->frame_time;
+    if (stats->frame_time > max_time) {
+      max_time = stats->frame_time;
+    }
+  }
+  if (g_draw_stats_num_frames > 0) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG,
+            "%u frames: %u ms average, %u ms max",
+            (unsigned int) g_draw_stats_num_frames,
+            (unsigned int) (total_time / g_draw_stats_num_frames),
+            (unsigned int) max_time);
+  }
+}
+#endif
+
+/*******************************************************************************
+   Function: draw_cells_at_depth
+
+Description: Draws the contents of every cell visible at a given depth by
+             building a display list for that depth and then rasterizing it.
+
+     Inputs: ctx   - Pointer to the relevant graphics context.
+             depth - Front-back visual depth of interest.
+
+    Outputs: "False" if nothing at or beyond the given depth can be visible
+             (e.g., because the cell straight ahead is out of bounds).
+*******************************************************************************/
+bool draw_cells_at_depth(GContext *ctx, const int8_t depth) {
+  if (!build_display_list(depth)) {
+    return false;
+  }
+  rasterize_display_list(ctx, depth);
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: build_display_list
+
+Description: Fills "g_display_list" with the walls, corner lines and
+             entrance/exit markers of every cell visible at a given depth,
+             without drawing anything. Only cells within the view's width at
+             that depth (see "g_visible_half_widths") and their immediate
+             neighbors are looked up, and cells lying entirely behind walls at
+             nearer depths are skipped. Beyond "LOW_DETAIL_DEPTH", corner
+             lines are left out.
+
+     Inputs: depth - Front-back visual depth of interest.
+
+    Outputs: "False" if nothing at or beyond the given depth can be visible
+             (e.g., because the cell straight ahead is out of bounds).
+*******************************************************************************/
+bool build_display_list(const int8_t depth) {
+  int8_t i, position, half_width, cell_type;
+  int16_t left, right;
+  GPoint cell_coords, cells[(STRAIGHT_AHEAD * 2) + 3];  // By position + 1.
+  bool solid[(STRAIGHT_AHEAD * 2) + 3],  // Indexed by position + 1.
+       farther_solid[(STRAIGHT_AHEAD * 2) + 3],
+       back_wall, left_wall, right_wall;
+
+  g_display_list_size = 0;
+  cell_coords = get_cell_farther_away(g_player->position,
+                                      g_player->direction,
+                                      depth);
+  if (out_of_bounds(cell_coords)) {
+    return false;
+  }
+  if (depth >= MAX_VISIBILITY_DEPTH - 1 ||
+      g_back_wall_coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT].y -
+        g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y <
+        MIN_WALL_HEIGHT) {
+    return false;  // Too far away to be drawn (as is everything beyond).
+  }
+  half_width = g_visible_half_widths[depth];
+
+  // Look up the solidity of the potentially visible cells, their immediate
+  // neighbors, and the cells one step farther away:
+  for (i = 0; i < (STRAIGHT_AHEAD * 2) + 3; ++i) {
+    solid[i] = farther_solid[i] = true;
+  }
+  for (position = STRAIGHT_AHEAD - half_width - 1;
+       position <= STRAIGHT_AHEAD + half_width + 1;
+       ++position) {
+    cells[position + 1] = get_cell_to_the_right(cell_coords,
+                                                g_player->direction,
+                                                position - STRAIGHT_AHEAD);
+    solid[position + 1] = is_solid(cells[position + 1]);
+    farther_solid[position + 1] =
+      is_solid(get_cell_farther_away(cells[position + 1],
+                                     g_player->direction,
+                                     1));
+  }
+
+  // Add the contents of each visible cell:
+  for (position = STRAIGHT_AHEAD - half_width;
+       position <= STRAIGHT_AHEAD + half_width;
+       ++position) {
+    if (solid[position + 1]) {
+      continue;
+    }
+
+    // Skip cells lying entirely behind nearer walls (checking the columns
+    // spanned by both the near and far sides of the cell):
+    if (depth > 0) {
+      left = g_back_wall_coords[depth - 1][position][TOP_LEFT].x;
+      if (g_back_wall_coords[depth][position][TOP_LEFT].x < left) {
+        left = g_back_wall_coords[depth][position][TOP_LEFT].x;
+      }
+      right = g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].x;
+      if (g_back_wall_coords[depth][position][BOTTOM_RIGHT].x > right) {
+        right = g_back_wall_coords[depth][position][BOTTOM_RIGHT].x;
+      }
+      if (columns_are_covered(left, right)) {
+        continue;
+      }
+    }
+
+    // Walls:
+    back_wall = farther_solid[position + 1];
+    left_wall = position <= STRAIGHT_AHEAD && solid[position];
+    right_wall = position >= STRAIGHT_AHEAD && solid[position + 2];
+    if (back_wall) {
+      add_display_list_item(BACK_WALL_ITEM, position);
+    }
+    if (left_wall) {
+      add_display_list_item(LEFT_WALL_ITEM, position);
+    }
+    if (right_wall) {
+      add_display_list_item(RIGHT_WALL_ITEM, position);
+    }
+
+    // Vertical lines at corners (each keyed by the cell to its right, so a
+    // line shared by neighboring cells is recognized as a duplicate), unless
+    // the cell is far away or the render quality has been lowered that far:
+    if (depth < LOW_DETAIL_DEPTH &&
+        g_render_quality < NO_CORNER_LINES_QUALITY) {
+      if ((back_wall && (left_wall || !farther_solid[position])) ||
+          (left_wall && !farther_solid[position])) {
+        add_display_list_item(CORNER_LINE_ITEM, position);
+      }
+      if ((back_wall && (right_wall || !farther_solid[position + 2])) ||
+          (right_wall && !farther_solid[position + 2])) {
+        add_display_list_item(CORNER_LINE_ITEM, position + 1);
+      }
+    }
+
+    // Entrance/exit markers:
+    cell_type = get_cell_type(cells[position + 1]);
+    if (cell_type == ENTRANCE) {
+      add_display_list_item(ENTRANCE_ITEM, position);
+    } else if (cell_type == EXIT) {
+      add_display_list_item(EXIT_ITEM, position);
+    }
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: add_display_list_item
+
+Description: Appends a primitive to "g_display_list".
+
+     Inputs: type     - Type of primitive (see the display list item types).
+             position - Left-right visual position of the primitive's cell in
+                        "g_back_wall_coords" (for corner lines, that of the
+                        cell to the line's right).
+
+    Outputs: "False" if the display list is already full.
+*******************************************************************************/
+bool add_display_list_item(const int8_t type, const int8_t position) {
+  if (g_display_list_size >= DISPLAY_LIST_MAX_ITEMS) {
+    return false;
+  }
+  g_display_list[g_display_list_size].type = type;
+  g_display_list[g_display_list_size].position = position;
+  g_display_list_size++;
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: rasterize_display_list
+
+Description: Sorts "g_display_list" by type and position, drops duplicate
+             primitives, then draws what's left: first the walls, then all the
+             black primitives (corner lines and markers) as a single batch.
+
+     Inputs: ctx   - Pointer to the relevant graphics context.
+             depth - Front-back visual depth of the display list's contents.
+
+    Outputs: None.
+*******************************************************************************/
+void rasterize_display_list(GContext *ctx, const int8_t depth) {
+  int8_t i, j, position;
+  int16_t left, right, top, bottom, y_offset;
+  display_list_item_t item;
+
+  // Insertion sort (the list is short and mostly in order already):
+  for (i = 1; i < g_display_list_size; ++i) {
+    item = g_display_list[i];
+    for (j = i - 1;
+         j >= 0 &&
+           DISPLAY_LIST_SORT_KEY(g_display_list[j]) >
+             DISPLAY_LIST_SORT_KEY(item);
+         --j) {
+      g_display_list[j + 1] = g_display_list[j];
+    }
+    g_display_list[j + 1] = item;
+  }
+
+  // Drop duplicates (which are now adjacent):
+  for (i = j = 0; i < g_display_list_size; ++i) {
+    if (j == 0 ||
+        DISPLAY_LIST_SORT_KEY(g_display_list[i]) !=
+          DISPLAY_LIST_SORT_KEY(g_display_list[j - 1])) {
+      g_display_list[j++] = g_display_list[i];
+    }
+  }
+  g_display_list_size = j;
+
+  // Now, draw each primitive:
+  if (depth == 0) {
+    y_offset = g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y;
+  } else {
+    y_offset = g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y -
+               g_back_wall_coords[depth - 1][STRAIGHT_AHEAD][TOP_LEFT].y;
+  }
+  for (i = 0; i < g_display_list_size; ++i) {
+    position = g_display_list[i].position;
+    if (position <= STRAIGHT_AHEAD * 2) {
+      left = g_back_wall_coords[depth][position][TOP_LEFT].x;
+      right = g_back_wall_coords[depth][position][BOTTOM_RIGHT].x;
+    } else {  // Only a corner line can lie beyond the rightmost cell.
+      left = g_back_wall_coords[depth][position - 1][BOTTOM_RIGHT].x;
+      right = left;
+    }
+    top = g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y;
+    bottom = g_back_wall_coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT].y;
+    switch (g_display_list[i].type) {
+      case BACK_WALL_ITEM:
+        draw_wall(ctx,
+                  GPoint(left, top),
+                  GPoint(left, bottom),
+                  GPoint(right, top),
+                  GPoint(right, bottom),
+                  depth,
+                  NULL);
+        break;
+      case LEFT_WALL_ITEM:
+        draw_wall(ctx,
+                  GPoint(depth == 0 ? 0 :
+                           g_back_wall_coords[depth - 1][position][TOP_LEFT].x,
+                         top - y_offset),
+                  GPoint(depth == 0 ? 0 :
+                           g_back_wall_coords[depth - 1][position][TOP_LEFT].x,
+                         bottom + y_offset),
+                  GPoint(left, top),
+                  GPoint(left, bottom),
+                  depth,
+                  &g_side_wall_columns[LEFT_WALL][depth][position]);
+        break;
+      case RIGHT_WALL_ITEM:
+        draw_wall(ctx,
+                  GPoint(right, top),
+                  GPoint(right, bottom),
+                  GPoint(depth == 0 ? GRAPHICS_FRAME_WIDTH - 1 :
+                       g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].x,
+                         top - y_offset),
+                  GPoint(depth == 0 ? GRAPHICS_FRAME_WIDTH - 1 :
+                       g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].x,
+                         bottom + y_offset),
+                  depth,
+                  &g_side_wall_columns[RIGHT_WALL][depth]
+                                      [position - STRAIGHT_AHEAD]);
+        break;
+      case CORNER_LINE_ITEM:
+        draw_line_segment(ctx,
+                          GPoint(left, top + STATUS_BAR_HEIGHT),
+                          GPoint(left, bottom + STATUS_BAR_HEIGHT),
+                          GColorBlack);
+        break;
+      case ENTRANCE_ITEM:
+        draw_entrance(ctx, depth, position);
+        break;
+      default:  // case EXIT_ITEM:
+        draw_exit(ctx, depth, position);
+        break;
+    }
+  }
+}
+
+#ifdef RAYCASTING_ENGINE_ENABLED
+/*******************************************************************************
+   Function: draw_raycast_scene
+
+Description: Alternative to the wall-grid renderer in "draw_scene": casts one
+             ray per column from the center of the player's cell, stepping it
+             from cell boundary to cell boundary through "g_maze" with a Q16
+             fixed-point DDA, and draws a single wall column wherever it hits a
+             solid cell. Walls are textured or shaded like the wall-grid
+             renderer's at the same depth (i.e., with the same mips, offsets
+             and palettes), and a black edge is drawn along the nearer side of
+             every corner. Lowered render qualities flat-fill the walls, then
+             shorten the rays to "RAYCAST_REDUCED_DISTANCE", then drop the
+             corner edges. Unlike the wall-grid renderer, any view angle may be
+             used.
+
+     Inputs: ctx   - Pointer to the relevant graphics context.
+             angle - View angle (see "get_direction_angle").
+
+    Outputs: None.
+*******************************************************************************/
+void draw_raycast_scene(GContext *ctx, const int32_t angle) {
+  int16_t x, top, bottom, face, previous_top, previous_bottom, previous_face,
+          texture_column, texture_width, shading_offset;
+  int32_t direction_x, direction_y, plane_x, plane_y, ray_x, ray_y, delta_x,
+          delta_y, side_distance_x, side_distance_y, distance,
+          previous_distance, half_height, wall_offset;
+  int8_t step_x, step_y, depth;
+  GPoint cell;
+  bool hit, x_side, previous_hit, previous_x_side, textured;
+  GColor primary_color = GColorWhite;
+  const int32_t max_distance = g_render_quality >= NEAR_WALLS_QUALITY ?
+                                 RAYCAST_REDUCED_DISTANCE :
+                                 RAYCAST_MAX_DISTANCE;
+  const bool flat = g_render_quality >= FLAT_WALLS_QUALITY,
+             corner_lines = g_render_quality < NO_CORNER_LINES_QUALITY;
+
+  // Determine the view direction and the camera plane perpendicular to it
+  // (which sets the field of view):
+  direction_x = cos_lookup(angle);
+  direction_y = sin_lookup(angle);
+  plane_x = -direction_y * HALF_SCREEN_WIDTH / RAYCAST_FOCAL_LENGTH;
+  plane_y = direction_x * HALF_SCREEN_WIDTH / RAYCAST_FOCAL_LENGTH;
+
+  previous_hit = previous_x_side = false;
+  previous_top = previous_bottom = previous_face = 0;
+  previous_distance = max_distance;
+  for (x = 0; x < GRAPHICS_FRAME_WIDTH; ++x) {
+    // Determine the ray's direction and the distance it travels between cell
+    // boundaries along each axis:
+    ray_x = direction_x + plane_x * (2 * x + 1 - GRAPHICS_FRAME_WIDTH) /
+                            GRAPHICS_FRAME_WIDTH;
+    ray_y = direction_y + plane_y * (2 * x + 1 - GRAPHICS_FRAME_WIDTH) /
+                            GRAPHICS_FRAME_WIDTH;
+    delta_x = 0xFFFFFFFFu / (abs(ray_x) < RAYCAST_MIN_RAY_COMPONENT ?
+                               RAYCAST_MIN_RAY_COMPONENT : abs(ray_x));
+    delta_y = 0xFFFFFFFFu / (abs(ray_y) < RAYCAST_MIN_RAY_COMPONENT ?
+                               RAYCAST_MIN_RAY_COMPONENT : abs(ray_y));
+    step_x = ray_x < 0 ? -1 : 1;
+    step_y = ray_y < 0 ? -1 : 1;
+
+    // Step from cell to cell (starting halfway across the player's cell) until
+    // the ray hits a solid cell or exceeds the visibility depth:
+    cell = g_player->position;
+    side_distance_x = delta_x / 2;
+    side_distance_y = delta_y / 2;
+    hit = x_side = false;
+    for (;;) {
+      if (side_distance_x < side_distance_y) {
+        distance = side_distance_x;
+        side_distance_x += delta_x;
+        cell.x += step_x;
+        x_side = true;
+      } else {
+        distance = side_distance_y;
+        side_distance_y += delta_y;
+        cell.y += step_y;
+        x_side = false;
+      }
+      if (distance >= max_distance) {
+        break;
+      }
+      if (is_solid(cell)) {
+        hit = true;
+        break;
+      }
+    }
+    if (!hit) {
+      if (previous_hit && corner_lines) {  // Outline the previous wall's end.
+        draw_line_segment(ctx,
+                          GPoint(x - 1, previous_top + STATUS_BAR_HEIGHT),
+                          GPoint(x - 1, previous_bottom + STATUS_BAR_HEIGHT),
+                          GColorBlack);
+      }
+      draw_raycast_markers(ctx,
+                           x,
+                           GRAPHICS_FRAME_HEIGHT / 2 + 1,
+                           max_distance,
+                           ray_x,
+                           ray_y);
+      previous_hit = false;
+      continue;
+    }
+
+    // Project the wall onto the screen, and find the nearest depth whose back
+    // walls (and so texture mip) are no taller, as "draw_wall" would use:
+    half_height = (RAYCAST_FOCAL_LENGTH << (FIXED_POINT_SHIFT - 1)) / distance;
+    depth = 0;
+    if (g_wall_texture.data != NULL && !flat) {
+      while (depth < NUM_DETAILED_DEPTHS &&
+             g_wall_texture.tile_heights[depth] > half_height) {
+        depth++;
+      }
+    }
+    textured = g_wall_texture.data != NULL &&
+               !flat &&
+               depth < NUM_DETAILED_DEPTHS;
+
+    // Determine where along the wall's face the ray hit (for texturing, from
+    // the wall's left to its right as seen) and which face it was (for
+    // outlining corners):
+    if (x_side) {
+      wall_offset = ((int32_t) g_player->position.y << FIXED_POINT_SHIFT) +
+                    FIXED_POINT_ONE / 2 +
+                    (int32_t) (((int64_t) distance * ray_y) >>
+                               FIXED_POINT_SHIFT);
+      face = cell.x + (step_x < 0 ? 1 : 0);
+    } else {
+      wall_offset = ((int32_t) g_player->position.x << FIXED_POINT_SHIFT) +
+                    FIXED_POINT_ONE / 2 +
+                    (int32_t) (((int64_t) distance * ray_x) >>
+                               FIXED_POINT_SHIFT);
+      face = cell.y + (step_y < 0 ? 1 : 0);
+    }
+    texture_width = textured ? 2 * g_wall_texture.tile_widths[depth] :
+                               RAYCAST_TEXTURE_WIDTH;  // A cell's worth.
+    texture_column = ((wall_offset & (FIXED_POINT_ONE - 1)) *
+                      texture_width) >> FIXED_POINT_SHIFT;
+    if (x_side ? step_x < 0 : step_y > 0) {
+      texture_column = texture_width - 1 - texture_column;
+    }
+
+    // Draw the column, textured as in "draw_wall" if near enough (mapping the
+    // texture onto the wall's full height, of which only the part within the
+    // graphics frame is drawn) or else shaded (with the points' rows following
+    // the wall's top edge and alternating texture columns offset by half a
+    // period, or every point colored when walls are flat-filled), then add
+    // black top and bottom edges:
+    if (textured) {
+      draw_textured_wall_column(ctx,
+                                x,
+                                GRAPHICS_FRAME_HEIGHT / 2 - half_height,
+                                GRAPHICS_FRAME_HEIGHT / 2 + half_height,
+                                depth,
+                                texture_column);
+    }
+    if (half_height > GRAPHICS_FRAME_HEIGHT / 2) {
+      half_height = GRAPHICS_FRAME_HEIGHT / 2;
+    }
+    top = GRAPHICS_FRAME_HEIGHT / 2 - half_height;
+    bottom = GRAPHICS_FRAME_HEIGHT / 2 + half_height;
+    if (!textured) {
+      shading_offset = flat ? 1 : g_shading_offsets[top];
+#ifdef PBL_COLOR
+      primary_color = g_background_colors[g_maze->wall_color_scheme]
+                                         [g_shading_color_indices[top]];
+#endif
+      draw_wall_column(ctx,
+                       x,
+                       top,
+                       bottom,
+                       shading_offset,
+                       (texture_column % 2 == 0 ? 0 : (shading_offset / 2) +
+                                                      (shading_offset % 2)) -
+                         top,
+                       primary_color);
+    }
+    draw_line_segment(ctx,
+                      GPoint(x, top + STATUS_BAR_HEIGHT),
+                      GPoint(x, top + STATUS_BAR_HEIGHT),
+                      GColorBlack);
+    draw_line_segment(ctx,
+                      GPoint(x, bottom + STATUS_BAR_HEIGHT),
+                      GPoint(x, bottom + STATUS_BAR_HEIGHT),
+                      GColorBlack);
+
+    // Outline corners and wall ends on whichever side is nearer:
+    if (corner_lines &&
+        (!previous_hit || x_side != previous_x_side || face != previous_face)) {
+      if (x > 0 && previous_hit && previous_distance < distance) {
+        draw_line_segment(ctx,
+                          GPoint(x - 1, previous_top + STATUS_BAR_HEIGHT),
+                          GPoint(x - 1, previous_bottom + STATUS_BAR_HEIGHT),
+                          GColorBlack);
+      } else if (x > 0) {
+        draw_line_segment(ctx,
+                          GPoint(x, top + STATUS_BAR_HEIGHT),
+                          GPoint(x, bottom + STATUS_BAR_HEIGHT),
+                          GColorBlack);
+      }
+    }
+    draw_raycast_markers(ctx, x, bottom + 1, max_distance, ray_x, ray_y);
+    previous_hit = true;
+    previous_x_side = x_side;
+    previous_face = face;
+    previous_distance = distance;
+    previous_top = top;
+    previous_bottom = bottom;
+  }
+}
+
+/*******************************************************************************
+   Function: draw_raycast_markers
+
+Description: Draws the parts of any entrance or exit markers visible in a given
+             column of the raycast scene by casting the column's ray onto the
+             floor (and, mirrored, the ceiling) at every row between the
+             nearest wall's bottom edge and the bottom of the graphics frame.
+
+     Inputs: ctx          - Pointer to the relevant graphics context.
+             x            - Column of interest.
+             first_row    - Topmost floor row not hidden by a wall (with
+                            respect to the graphics frame).
+             max_distance - Distance (Q16, in cells) beyond which markers
+                            aren't drawn.
+             ray_x        - Horizontal component of the column's ray (Q16).
+             ray_y        - Vertical component of the column's ray (Q16).
+
+    Outputs: None.
+*******************************************************************************/
+void draw_raycast_markers(GContext *ctx,
+                          const int16_t x,
+                          const int16_t first_row,
+                          const int32_t max_distance,
+                          const int32_t ray_x,
+                          const int32_t ray_y) {
+  int16_t y;
+  int32_t distance, point_x, point_y, offset_x, offset_y;
+  GPoint cell;
+
+  // Work upward from the bottom of the frame, i.e., from near to far:
+  for (y = GRAPHICS_FRAME_HEIGHT; y >= first_row; --y) {
+    distance = g_floor_distances[y - GRAPHICS_FRAME_HEIGHT / 2];
+    if (distance >= max_distance) {
+      break;
+    }
+    point_x = ((int32_t) g_player->position.x << FIXED_POINT_SHIFT) +
+              FIXED_POINT_ONE / 2 +
+              (int32_t) (((int64_t) distance * ray_x) >> FIXED_POINT_SHIFT);
+    point_y = ((int32_t) g_player->position.y << FIXED_POINT_SHIFT) +
+              FIXED_POINT_ONE / 2 +
+              (int32_t) (((int64_t) distance * ray_y) >> FIXED_POINT_SHIFT);
+
+    // Markers are discs centered on their cells (Q8 offsets keep the squares
+    // within 32 bits):
+    offset_x = ((point_x & (FIXED_POINT_ONE - 1)) - FIXED_POINT_ONE / 2) >> 8;
+    offset_y = ((point_y & (FIXED_POINT_ONE - 1)) - FIXED_POINT_ONE / 2) >> 8;
+    if (offset_x * offset_x + offset_y * offset_y >
+          RAYCAST_MARKER_RADIUS_SQUARED) {
+      continue;
+    }
+    cell = GPoint(point_x >> FIXED_POINT_SHIFT, point_y >> FIXED_POINT_SHIFT);
+    if (out_of_bounds(cell)) {
+      continue;
+    }
+    if (get_cell_type(cell) == EXIT) {
+      draw_line_segment(ctx,
+                        GPoint(x, y + STATUS_BAR_HEIGHT),
+                        GPoint(x, y + STATUS_BAR_HEIGHT),
+                        GColorBlack);
+    } else if (get_cell_type(cell) == ENTRANCE) {
+      draw_line_segment(ctx,
+                        GPoint(x, GRAPHICS_FRAME_HEIGHT - y + STATUS_BAR_HEIGHT),
+                        GPoint(x, GRAPHICS_FRAME_HEIGHT - y + STATUS_BAR_HEIGHT),
+                        GColorBlack);
+    }
+  }
+}
+
+/*******************************************************************************
+   Function: get_direction_angle
+
+Description: Converts a cardinal direction into a view angle for
+             "draw_raycast_scene".
+
+     Inputs: direction - Direction of interest.
+
+    Outputs: The corresponding angle, in "TRIG_MAX_ANGLE" units (with zero
+             facing east and angles increasing clockwise, so "cos_lookup" and
+             "sin_lookup" give the view's horizontal and vertical components in
+             "g_maze").
+*******************************************************************************/
+int32_t get_direction_angle(const int8_t direction) {
+  switch (direction) {
+    case NORTH:
+      return TRIG_MAX_ANGLE * 3 / 4;
+    case SOUTH:
+      return TRIG_MAX_ANGLE / 4;
+    case EAST:
+      return 0;
+    default:  // case WEST:
+      return TRIG_MAX_ANGLE / 2;
+  }
+}
+
+#endif
+
+/*******************************************************************************
+   Function: mark_column_covered
+
+Description: Records that a column has been covered by a wall at the current
+             depth. (This takes effect once "update_column_coverage" is called,
+             so walls at the same depth never hide one another.)
+
+     Inputs: x      - Horizontal coordinate of the column.
+             top    - Topmost point of the wall (with respect to the graphics
+                      frame).
+             bottom - Point just below the wall's lowest point.
+
+    Outputs: None.
+*******************************************************************************/
+void mark_column_covered(const int16_t x,
+                         const int16_t top,
+                         const int16_t bottom) {
+  uint32_t bit;
+
+  if (x < 0 || x >= GRAPHICS_FRAME_WIDTH) {
+    return;
+  }
+  bit = 1u << (x % 32);
+  if (g_new_column_coverage[x / 32] & bit) {  // Shared by two walls.
+    if (top < g_new_covered_tops[x]) {
+      g_new_covered_tops[x] = top;
+    }
+    if (bottom > g_new_covered_bottoms[x]) {
+      g_new_covered_bottoms[x] = bottom;
+    }
+  } else {
+    g_new_column_coverage[x / 32] |= bit;
+    g_new_covered_tops[x] = top;
+    g_new_covered_bottoms[x] = bottom;
+  }
+}
+
+/*******************************************************************************
+   Function: columns_are_covered
+
+Description: Determines whether every on-screen column in a given range is
+             hidden behind a nearer wall.
+
+     Inputs: left  - Leftmost column of the range.
+             right - Rightmost column of the range.
+
+    Outputs: "True" if no column in the range is still visible.
+*******************************************************************************/
+bool columns_are_covered(int16_t left, int16_t right) {
+  int16_t i;
+  uint32_t span;
+
+  if (left < 0) {
+    left = 0;
+  }
+  if (right >= GRAPHICS_FRAME_WIDTH) {
+    right = GRAPHICS_FRAME_WIDTH - 1;
+  }
+  for (i = left / 32; left <= right && i <= right / 32; ++i) {
+    span = ~0u;
+    if (i == left / 32) {
+      span &= ~0u << (left % 32);
+    }
+    if (i == right / 32) {
+      span &= ~0u >> (31 - right % 32);
+    }
+    if ((g_column_coverage[i] & span) != span) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: update_column_coverage
+
+Description: Adds the columns covered by walls at the current depth (see
+             "mark_column_covered") to the global coverage buffer, which hides
+             them from everything drawn at greater depths. (A nearer wall is
+             always taller than anything behind it, so a column's covered span
+             is set only once.)
+
+     Inputs: None.
+
+    Outputs: "True" if every column of the graphics frame is now covered.
+*******************************************************************************/
+bool update_column_coverage(void) {
+  int16_t i;
+
+  for (i = 0; i < GRAPHICS_FRAME_WIDTH; ++i) {
+    if ((g_new_column_coverage[i / 32] >> (i % 32)) & 1 &&
+        !COLUMN_IS_COVERED(i)) {
+      g_covered_tops[i] = g_new_covered_tops[i];
+      g_covered_bottoms[i] = g_new_covered_bottoms[i];
+    }
+  }
+  for (i = 0; i < COLUMN_COVERAGE_WORDS; ++i) {
+    g_column_coverage[i] |= g_new_column_coverage[i];
+    g_new_column_coverage[i] = 0;
+  }
+
+  return columns_are_covered(0, GRAPHICS_FRAME_WIDTH - 1);
+}
+
+/*******************************************************************************
+   Function: cache_frame
+
+Description: Compresses the 3D view currently in the captured frame buffer,
+             keyed by the player's position and direction, and makes it the
+             shown frame (see "draw_scene"). A full-quality view compressing to
+             no more than "FRAME_CACHE_SCRATCH_SIZE" is stored in the frame
+             cache, evicting the least recently used views as needed to stay
+             within the budget; any other view is kept in "g_uncached_frame"
+             only until the next one is drawn, and only if it fits in the
+             budget alongside the cached views. (The scratch buffer below is
+             part of "FRAME_CACHE_BUDGET", and room is made before allocating,
+             so the cache never holds more.)
+
+             Each row is compressed against two reference rows: whichever of
+             the preceding "FRAME_CACHE_MAX_ROW_REFERENCE" rows it most
+             resembles (walls are shaded in vertically repeating patterns) and
+             the same row of "g_backdrop" (for visible floor and ceiling). A
+             header byte holds the former's distance (or zero), followed by runs
+             that each start with an op byte: the top two bits select literal
+             bytes (which follow the op byte), a copy from the preceding row or
+             a copy from the backdrop, and the low six bits hold the run length
+             minus one.
+
+             Rows are compressed into "g_frame_cache_scratch" while they're
+             sure to fit, then copied into an allocation of exactly the
+             compressed size, so no large block is allocated and shrunk for
+             every new view. Any rows that don't fit (mostly in views too large
+             to cache) are measured in the scratch buffer's last
+             "FRAME_CACHE_MAX_ROW_SIZE" bytes first, then compressed straight
+             into the allocation.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void cache_frame(void) {
+  int16_t i, y, first_unfitted_row;
+  uint16_t size = 0, fitted_size;
+  uint8_t *data;
+  int8_t row_references[GRAPHICS_FRAME_HEIGHT + 1];  // See "BACKDROP_FRAME".
+  cached_frame_t *frame, *oldest_frame;
+
+  free(g_uncached_frame.data);
+  g_uncached_frame.data = NULL;
+  g_shown_frame = NULL;
+  if (g_backdrop == NULL) {
+    return;
+  }
+  for (y = 0;
+       y < BACKDROP_FRAME.size.h &&
+         size + 2 * FRAME_CACHE_MAX_ROW_SIZE <= FRAME_CACHE_SCRATCH_SIZE;
+       ++y) {  // (Leaving room at the end to measure any remaining rows.)
+    row_references[y] = find_frame_row_reference(y);
+    size += compress_frame_row(y,
+                               row_references[y],
+                               g_frame_cache_scratch + size);
+  }
+  fitted_size = size;
+  first_unfitted_row = y;
+  for (; y < BACKDROP_FRAME.size.h; ++y) {
+    row_references[y] = find_frame_row_reference(y);
+    size += compress_frame_row(y,
+                               row_references[y],
+                               g_frame_cache_scratch +
+                                 FRAME_CACHE_SCRATCH_SIZE -
+                                 FRAME_CACHE_MAX_ROW_SIZE);
+  }
+
+  // Unless the view isn't worth caching, find an empty slot, evicting the
+  // least recently used frames as needed:
+  if (g_render_quality != FULL_QUALITY || size > FRAME_CACHE_SCRATCH_SIZE) {
+    if (g_frame_cache_size + size > FRAME_CACHE_HEAP_BUDGET) {
+      return;  // Redrawn if needed again.
+    }
+    frame = &g_uncached_frame;
+  } else {
+    for (;;) {
+      frame = oldest_frame = NULL;
+      for (i = 0; i < FRAME_CACHE_MAX_FRAMES; ++i) {
+        if (g_frame_cache[i].data == NULL) {
+          if (frame == NULL) {
+            frame = &g_frame_cache[i];
+          }
+        } else if (oldest_frame == NULL ||
+                   g_frame_cache[i].last_used < oldest_frame->last_used) {
+          oldest_frame = &g_frame_cache[i];
+        }
+      }
+      if (frame != NULL &&
+          g_frame_cache_size + size <= FRAME_CACHE_HEAP_BUDGET) {
+        break;
+      }
+      free(oldest_frame->data);
+      oldest_frame->data = NULL;
+      g_frame_cache_size -= oldest_frame->size;
+    }
+  }
+  data = malloc(size);
+  if (data == NULL) {
+    return;
+  }
+  memcpy(data, g_frame_cache_scratch, fitted_size);
+  for (y = first_unfitted_row, i = fitted_size;
+       y < BACKDROP_FRAME.size.h;
+       ++y) {
+    i += compress_frame_row(y, row_references[y], data + i);
+  }
+  if (frame != &g_uncached_frame) {
+    g_frame_cache_size += size;
+  }
+  frame->data = data;
+  frame->size = size;
+  frame->maze_id = g_maze_id;
+  frame->last_used = ++g_frame_cache_clock;
+  frame->position = g_player->position;
+  frame->direction = g_player->direction;
+  g_shown_frame = frame;
+}
+
+/*******************************************************************************
+   Function: find_frame_row_reference
+
+Description: Finds which of the preceding "FRAME_CACHE_MAX_ROW_REFERENCE" rows
+             of the captured frame buffer (that span a given row) the row most
+             resembles, for "cache_frame".
+
+     Inputs: y - The row, relative to "BACKDROP_FRAME".
+
+    Outputs: How many rows back the most similar row lies, or zero if none
+             matches a single byte (in which case the backdrop is used).
+*******************************************************************************/
+int8_t find_frame_row_reference(const int16_t y) {
+  int16_t i, k, matches, most_matches = 0;
+  int8_t best_k = 0;
+  const uint8_t *const row = FRAME_BUFFER_ROW(BACKDROP_FRAME.origin.y + y),
+                *reference;
+  const int16_t start = FRAME_CACHE_ROW_START(BACKDROP_FRAME.origin.y + y),
+                end = FRAME_CACHE_ROW_END(BACKDROP_FRAME.origin.y + y);
+
+  for (k = 1; k <= FRAME_CACHE_MAX_ROW_REFERENCE && k <= y; ++k) {
+    if (FRAME_CACHE_ROW_START(BACKDROP_FRAME.origin.y + y - k) > start ||
+        FRAME_CACHE_ROW_END(BACKDROP_FRAME.origin.y + y - k) < end) {
+      continue;
+    }
+    reference = FRAME_BUFFER_ROW(BACKDROP_FRAME.origin.y + y - k);
+    for (i = start, matches = 0; i < end; ++i) {
+      if (row[i] == reference[i]) {
+        matches++;
+      }
+    }
+    if (matches > most_matches) {
+      most_matches = matches;
+      best_k = k;
+    }
+  }
+
+  return best_k;
+}
+
+/*******************************************************************************
+   Function: compress_frame_row
+
+Description: Compresses a row of the captured frame buffer against a given
+             reference row and the same row of "g_backdrop" (see
+             "cache_frame").
+
+     Inputs: y         - The row, relative to "BACKDROP_FRAME".
+             reference - How many rows back the reference row lies (see
+                         "find_frame_row_reference"), or zero for the
+                         backdrop's.
+             data      - Where to write the compressed row.
+
+    Outputs: The no. of compressed bytes (incl. the header byte).
+*******************************************************************************/
+uint16_t compress_frame_row(const int16_t y,
+                            const int8_t reference,
+                            uint8_t *const data) {
+  int16_t i, run, backdrop_run;
+  uint16_t size = 0;
+  const uint8_t *const row = FRAME_BUFFER_ROW(BACKDROP_FRAME.origin.y + y),
+                *const backdrop_row = gbitmap_get_data(g_backdrop) +
+                                        y * gbitmap_get_bytes_per_row(
+                                              g_backdrop),
+                *const reference_row = reference > 0 ?
+                                         FRAME_BUFFER_ROW(
+                                           BACKDROP_FRAME.origin.y + y -
+                                             reference) :
+                                         backdrop_row;
+  const int16_t start = FRAME_CACHE_ROW_START(BACKDROP_FRAME.origin.y + y),
+                end = FRAME_CACHE_ROW_END(BACKDROP_FRAME.origin.y + y);
+
+  data[size++] = reference;
+
+  // Emit the longest available copy or else a run of literal bytes:
+  for (i = start; i < end; i += run) {
+    for (run = 0;
+         i + run < end &&
+           run < FRAME_CACHE_MAX_RUN &&
+           row[i + run] == reference_row[i + run];
+         ++run);
+    for (backdrop_run = 0;
+         i + backdrop_run < end &&
+           backdrop_run < FRAME_CACHE_MAX_RUN &&
+           row[i + backdrop_run] == backdrop_row[i + backdrop_run];
+         ++backdrop_run);
+    if (backdrop_run >= 2 && backdrop_run >= run) {
+      run = backdrop_run;
+      data[size++] = FRAME_CACHE_BACKDROP_COPY | (run - 1);
+      continue;
+    } else if (run >= 2) {
+      data[size++] = FRAME_CACHE_ROW_COPY | (run - 1);
+      continue;
+    }
+    for (run = 1;
+         i + run < end &&
+           run < FRAME_CACHE_MAX_RUN &&
+           !(i + run + 1 < end &&
+             ((row[i + run] == reference_row[i + run] &&
+               row[i + run + 1] == reference_row[i + run + 1]) ||
+              (row[i + run] == backdrop_row[i + run] &&
+               row[i + run + 1] == backdrop_row[i + run + 1])));
+         ++run);
+    data[size++] = FRAME_CACHE_LITERAL | (run - 1);
+    memcpy(data + size, row + i, run);
+    size += run;
+  }
+
+  return size;
+}
+
+/*******************************************************************************
+   Function: find_cached_frame
+
+Description: Looks for the player's current view in the frame cache.
+
+     Inputs: None.
+
+    Outputs: Pointer to the cached view, or "NULL" if it isn't cached.
+*******************************************************************************/
+cached_frame_t *find_cached_frame(void) {
+  int8_t i;
+
+  for (i = 0; i < FRAME_CACHE_MAX_FRAMES; ++i) {
+    if (g_frame_cache[i].data != NULL &&
+        g_frame_cache[i].maze_id == g_maze_id &&
+        g_frame_cache[i].direction == g_player->direction &&
+        gpoint_equal(&g_frame_cache[i].position, &g_player->position)) {
+      return &g_frame_cache[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*******************************************************************************
+   Function: restore_cached_frame
+
+Description: Decompresses a stored view straight into the frame buffer (see
+             "cache_frame") and makes it the shown frame.
+
+     Inputs: layer - Pointer to the relevant layer.
+             ctx   - Pointer to the relevant graphics context.
+             frame - Pointer to the view (from the frame cache, or
+                     "g_shown_frame"), or "NULL".
+
+    Outputs: "True" if the view was restored.
+*******************************************************************************/
+bool restore_cached_frame(Layer *layer,
+                          GContext *ctx,
+                          cached_frame_t *const frame) {
+  int16_t i, y, run, end;
+  uint8_t *data, *row, *reference, *backdrop_row;
+
+  if (frame == NULL || g_backdrop == NULL) {
+    return false;
+  }
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_fill_rect(ctx,
+                     layer_get_bounds(layer),
+                     NO_CORNER_RADIUS,
+                     GCornerNone);
+  if (!capture_frame_buffer(ctx)) {
+    return false;
+  }
+  data = frame->data;
+  for (y = 0; y < BACKDROP_FRAME.size.h; ++y) {
+    row = FRAME_BUFFER_ROW(BACKDROP_FRAME.origin.y + y);
+    backdrop_row = gbitmap_get_data(g_backdrop) +
+                     y * gbitmap_get_bytes_per_row(g_backdrop);
+    reference = *data > 0 ?
+                  FRAME_BUFFER_ROW(BACKDROP_FRAME.origin.y + y - *data) :
+                  backdrop_row;
+    data++;
+    end = FRAME_CACHE_ROW_END(BACKDROP_FRAME.origin.y + y);
+    for (i = FRAME_CACHE_ROW_START(BACKDROP_FRAME.origin.y + y);
+         i < end;
+         i += run) {
+      run = (*data & ~FRAME_CACHE_OP_MASK) + 1;
+      switch (*data++ & FRAME_CACHE_OP_MASK) {
+        case FRAME_CACHE_ROW_COPY:
+          memcpy(row + i, reference + i, run);
+          break;
+        case FRAME_CACHE_BACKDROP_COPY:
+          memcpy(row + i, backdrop_row + i, run);
+          break;
+        default:  // case FRAME_CACHE_LITERAL:
+          memcpy(row + i, data, run);
+          data += run;
+          break;
+      }
+    }
+  }
+  release_frame_buffer(ctx);
+  frame->last_used = ++g_frame_cache_clock;
+  if (frame != &g_uncached_frame) {
+    free(g_uncached_frame.data);
+    g_uncached_frame.data = NULL;
+  }
+  g_shown_frame = frame;
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: clear_frame_cache
+
+Description: Frees every view stored in the frame cache, along with any
+             uncached shown frame.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void clear_frame_cache(void) {
+  int8_t i;
+
+  for (i = 0; i < FRAME_CACHE_MAX_FRAMES; ++i) {
+    free(g_frame_cache[i].data);
+    g_frame_cache[i].data = NULL;
+  }
+  g_frame_cache_size = 0;
+  free(g_uncached_frame.data);
+  g_uncached_frame.data = NULL;
+  g_shown_frame = NULL;
+}
+
+/*******************************************************************************
+   Function: draw_floor_and_ceiling
+
+Description: Draws the floor and ceiling, either into the current frame buffer
+             (if captured) or via the graphics context.
+
+     Inputs: ctx - Pointer to the relevant graphics context (only used if
+                   the frame buffer hasn't been captured).
+             top - Vertical coordinate corresponding to the top of the
+                   graphics frame.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_floor_and_ceiling(GContext *ctx, const int16_t top) {
+  uint8_t x, y, max_y, shading_offset;
+  GColor color = GColorWhite;
+
+  max_y = g_back_wall_coords[MAX_VISIBILITY_DEPTH - 2][0][TOP_LEFT].y;
+  if (g_frame_buffer == NULL) {
+    graphics_context_set_stroke_color(ctx, color);
+  }
+  for (y = 0; y < max_y; ++y) {
+    // Determine horizontal distance between points:
+    shading_offset = g_shading_offsets[y];
+#ifdef PBL_COLOR
+    color = g_background_colors[g_maze->floor_color_scheme]
+                               [g_shading_color_indices[y]];
+    if (g_frame_buffer == NULL) {
+      graphics_context_set_stroke_color(ctx, color);
+    }
+#endif
+    x = y % 2 ? 0 : (shading_offset / 2) + (shading_offset % 2);
+#ifdef PBL_BW
+    if (g_frame_buffer != NULL) {
+      draw_dotted_row(y + top, x, shading_offset);
+      draw_dotted_row(GRAPHICS_FRAME_HEIGHT - y + top,
+                      x,
+                      shading_offset);
+      continue;
+    }
+#endif
+    for (; x < GRAPHICS_FRAME_WIDTH; x += shading_offset) {
+      // Draw one point on the ceiling and another on the floor:
+      if (g_frame_buffer != NULL) {
+        draw_frame_buffer_pixel(x, y + top, color);
+        draw_frame_buffer_pixel(x,
+                                GRAPHICS_FRAME_HEIGHT - y + top,
+                                color);
+      } else {
+        graphics_draw_pixel(ctx, GPoint(x, y + top));
+        graphics_draw_pixel(ctx, GPoint(x, GRAPHICS_FRAME_HEIGHT - y + top));
+      }
+    }
+  }
+}
+
+/*******************************************************************************
+   Function: update_backdrop
+
+Description: Renders the floor and ceiling, over a black background, into the
+             offscreen "g_backdrop" bitmap so "draw_scene" can blit them in a
+             single call. The bitmap is only (re)built when it doesn't yet exist
+             or, on color platforms, when the maze's floor color scheme
+             changes.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void update_backdrop(void) {
+#ifdef PBL_COLOR
+  if (g_backdrop != NULL &&
+      g_backdrop_color_scheme == g_maze->floor_color_scheme) {
+    return;
+  }
+#else
+  if (g_backdrop != NULL) {  // There's only one backdrop on aplite.
+    return;
+  }
+#endif
+  if (g_backdrop == NULL) {
+#ifdef PBL_COLOR
+    g_backdrop = gbitmap_create_blank(BACKDROP_FRAME.size, GBitmapFormat8Bit);
+#else
+    g_backdrop = gbitmap_create_blank(BACKDROP_FRAME.size, GBitmapFormat1Bit);
+#endif
+    if (g_backdrop == NULL) {
+      return;  // "draw_scene" will draw the floor and ceiling itself.
+    }
+  }
+
+  // Point the frame buffer at the bitmap and draw into it:
+  set_frame_buffer(g_backdrop);
+  memset(g_frame_buffer_data,
+#ifdef PBL_COLOR
+         GColorBlack.argb,
+#else
+         0,
+#endif
+         g_frame_buffer_row_size * BACKDROP_FRAME.size.h);
+  draw_floor_and_ceiling(NULL, 0);
+  g_frame_buffer = NULL;
+#ifdef PBL_COLOR
+  g_backdrop_color_scheme = g_maze->floor_color_scheme;
+#endif
+}
+
+/*******************************************************************************
+   Function: update_wall_texture
+
+Description: Loads the mips of the wall texture used by the maze's wall color
+             scheme into "g_wall_texture" (freeing any other texture's, so only
+             one set is ever held in memory) and builds a palette for each
+             depth short of "LOW_DETAIL_DEPTH" (farther walls being flat). If
+             the resource can't be loaded or doesn't match the wall geometry,
+             walls are shaded procedurally instead.
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void update_wall_texture(void) {
+  int8_t depth, texture;
+  uint8_t *texels;
+  size_t size;
+  bool valid;
+  ResHandle handle;
+#ifdef PBL_COLOR
+  int8_t color_index;
+  const GColor *colors;
+#endif
+
+  if (!WALL_TEXTURES_ENABLED) {
+    return;
+  }
+#ifdef PBL_COLOR
+  if (g_wall_texture.data != NULL &&
+      g_wall_texture.color_scheme == g_maze->wall_color_scheme) {
+    return;
+  }
+  texture = g_maze->wall_color_scheme % NUM_WALL_TEXTURES;
+#else
+  if (g_wall_texture.data != NULL) {  // There's only one texture on aplite.
+    return;
+  }
+  texture = BRICK_TEXTURE;
+#endif
+
+  // Load the texture, unless it's already loaded:
+  if (g_wall_texture.data == NULL || g_wall_texture.texture != texture) {
+    free(g_wall_texture.data);
+    handle = resource_get_handle(g_wall_texture_resource_ids[texture]);
+    size = resource_size(handle);
+    g_wall_texture.data = malloc(size);
+    if (g_wall_texture.data == NULL) {
+      return;
+    }
+    resource_load(handle, g_wall_texture.data, size);
+
+    // Locate each mip, checking that its tiles span half a cell each way:
+    texels = g_wall_texture.data + 1 + 2 * NUM_DETAILED_DEPTHS;
+    valid = size >= (size_t) (texels - g_wall_texture.data) &&
+            g_wall_texture.data[0] == NUM_DETAILED_DEPTHS;
+    for (depth = 0; valid && depth < NUM_DETAILED_DEPTHS; ++depth) {
+      g_wall_texture.tile_widths[depth] = g_wall_texture.data[1 + 2 * depth];
+      g_wall_texture.tile_heights[depth] = g_wall_texture.data[2 + 2 * depth];
+      g_wall_texture.mips[depth] = texels;
+      texels += g_wall_texture.tile_widths[depth] *
+                ((g_wall_texture.tile_heights[depth] + 3) / 4);
+      valid = texels <= g_wall_texture.data + size &&
+              g_wall_texture.tile_widths[depth] * 2 ==
+                g_back_wall_coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT].x -
+                g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].x &&
+              g_wall_texture.tile_heights[depth] * 2 ==
+                g_back_wall_coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT].y -
+                g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y;
+    }
+    if (!valid) {
+      free(g_wall_texture.data);
+      g_wall_texture.data = NULL;
+
+      return;
+    }
+    g_wall_texture.texture = texture;
+  }
+
+  // Build each depth's palette:
+  for (depth = 0; depth < NUM_DETAILED_DEPTHS; ++depth) {
+    g_wall_texture.palettes[depth][MORTAR_TEXEL] = GColorBlack;
+#ifdef PBL_COLOR
+    colors = g_background_colors[g_maze->wall_color_scheme];
+    color_index = g_shading_color_indices[
+                    g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y];
+    g_wall_texture.palettes[depth][SHADOW_TEXEL] =
+      colors[color_index + TEXTURE_SHADING_STEP <
+               NUM_BACKGROUND_COLORS_PER_SCHEME ?
+             color_index + TEXTURE_SHADING_STEP :
+             NUM_BACKGROUND_COLORS_PER_SCHEME - 1];
+    g_wall_texture.palettes[depth][FACE_TEXEL] = colors[color_index];
+    g_wall_texture.palettes[depth][HIGHLIGHT_TEXEL] =
+      colors[color_index > TEXTURE_SHADING_STEP ?
+             color_index - TEXTURE_SHADING_STEP :
+             0];
+#else
+    g_wall_texture.palettes[depth][SHADOW_TEXEL] = GColorBlack;
+    g_wall_texture.palettes[depth][FACE_TEXEL] = GColorWhite;
+    g_wall_texture.palettes[depth][HIGHLIGHT_TEXEL] = GColorWhite;
+#endif
+  }
+#ifdef PBL_COLOR
+  g_wall_texture.color_scheme = g_maze->wall_color_scheme;
+#endif
+}
+
+/*******************************************************************************
+   Function: draw_wall
+
+Description: Draws a wall according to specifications. Walls at or beyond
+             "LOW_DETAIL_DEPTH" are flat-filled, as are all walls once the
+             render quality has been lowered far enough.
+
+     Inputs: ctx         - Pointer to the relevant graphics context.
+             upper_left  - Coordinates for the wall's upper-left point.
+             lower_left  - Coordinates for the wall's lower-left point.
+             upper_right - Coordinates for the wall's upper-right point.
+             lower_right - Coordinates for the wall's lower-right point.
+             depth       - Front-back visual depth of the wall (or, for side
+                           walls, of its far edge).
+             columns     - For side walls, the wall's entry in
+                           "g_side_wall_columns" (its on-screen columns and
+                           the rise of its top edge at each); "NULL" for back
+                           walls, whose top edges are level.
+
+    Outputs: "True" if the wall is successfully drawn on the screen (i.e., the
+             wall isn't located entirely off-screen or behind nearer walls).
+*******************************************************************************/
+bool draw_wall(GContext *ctx,
+               const GPoint upper_left,
+               const GPoint lower_left,
+               const GPoint upper_right,
+               const GPoint lower_right,
+               const int8_t depth,
+               const wall_columns_t *const columns) {
+  int16_t i, j, first_column, num_columns, rise, truncated_rise, top, bottom,
+          shading_offset, half_shading_offset;
+  const int8_t *rises = NULL, *truncated_rises = NULL;
+  const uint8_t *texture_columns = NULL;
+  GColor primary_color = GColorWhite;
+  const bool flat = depth >= LOW_DETAIL_DEPTH ||
+                      g_render_quality >= FLAT_WALLS_QUALITY;
+  const bool textured = g_wall_texture.data != NULL && !flat;
+
+  if (columns_are_covered(upper_left.x < upper_right.x ? upper_left.x :
+                                                         upper_right.x,
+                          upper_left.x < upper_right.x ? upper_right.x :
+                                                         upper_left.x)) {
+    return false;  // (The edges are checked too, as they may run backward.)
+  }
+
+  // Determine which columns lie on-screen:
+  if (columns != NULL) {
+    first_column = columns->first_column;
+    num_columns = columns->num_columns;
+    rises = g_side_wall_rises + columns->first_rise_index;
+    truncated_rises = g_side_wall_truncated_rises + columns->first_rise_index;
+    texture_columns = g_side_wall_texture_columns + columns->first_rise_index;
+  } else {
+    first_column = upper_left.x < 0 ? 0 : upper_left.x;
+    num_columns = (upper_right.x < GRAPHICS_FRAME_WIDTH ?
+                     upper_right.x : GRAPHICS_FRAME_WIDTH - 1) -
+                  first_column + 1;
+  }
+
+#ifdef PBL_BW
+  // Back walls are shaded uniformly, so they can be drawn a row at a time:
+  if (g_frame_buffer != NULL && columns == NULL && !textured) {
+    draw_wall_rows(upper_left.x,
+                   upper_right.x,
+                   upper_left.y,
+                   lower_left.y,
+                   flat);
+    for (i = upper_left.x; i <= upper_right.x; ++i) {
+      mark_column_covered(i, upper_left.y, lower_left.y);
+    }
+  } else
+#endif
+  for (j = 0; j < num_columns; ++j) {
+    i = first_column + j;
+    if (COLUMN_IS_COVERED(i)) {
+      continue;
+    }
+    // Look up how far the top edge has risen (or fallen) at this column, both
+    // rounded down and rounded toward zero:
+    rise = rises == NULL ? 0 : rises[j];
+    truncated_rise = truncated_rises == NULL ? 0 : truncated_rises[j];
+    top = upper_left.y + rise;
+    bottom = lower_left.y - rise;
+#ifdef FLOAT_PROJECTION
+    if (columns != NULL) {
+      get_float_wall_edges(upper_left,
+                           lower_left,
+                           upper_right,
+                           i,
+                           &top,
+                           &bottom,
+                           &truncated_rise);
+    }
+#endif
+    if (textured) {
+      draw_textured_wall_column(ctx,
+                                i,
+                                top,
+                                bottom,
+                                depth,
+                                texture_columns == NULL ?
+                                  i - upper_left.x : texture_columns[j]);
+      mark_column_covered(i, top, bottom);
+      continue;
+    }
+
+    // Determine vertical distance between points (every point being colored
+    // when walls are flat-filled):
+    shading_offset = flat ? 1 : g_shading_offsets[top];
+    half_shading_offset = (shading_offset / 2) + (shading_offset % 2);
+#ifdef PBL_COLOR
+    primary_color = g_background_colors[g_maze->wall_color_scheme]
+                                       [g_shading_color_indices[top]];
+#endif
+
+    // Now, draw points from top to bottom:
+    draw_wall_column(ctx,
+                     i,
+                     top,
+                     bottom,
+                     shading_offset,
+                     truncated_rise + (i % 2 == 0 ? 0 : half_shading_offset),
+                     primary_color);
+    mark_column_covered(i, top, bottom);
+  }
+
+  // Draw lines along the top and bottom of the wall:
+  draw_line_segment(ctx,
+                    GPoint(upper_left.x, upper_left.y + STATUS_BAR_HEIGHT),
+                    GPoint(upper_right.x, upper_right.y + STATUS_BAR_HEIGHT),
+                    GColorBlack);
+  draw_line_segment(ctx,
+                    GPoint(lower_left.x, lower_left.y + STATUS_BAR_HEIGHT),
+                    GPoint(lower_right.x, lower_right.y + STATUS_BAR_HEIGHT),
+                    GColorBlack);
+
+  // Ad hoc solution to a minor visual issue (remove if no longer relevant):
+  if (upper_left.y == g_back_wall_coords[1][0][TOP_LEFT].y) {
+    draw_line_segment(ctx,
+                      GPoint(lower_left.x,
+                             lower_left.y + 1 + STATUS_BAR_HEIGHT),
+                      GPoint(lower_right.x,
+                             lower_right.y + 1 + STATUS_BAR_HEIGHT),
+                      GColorBlack);
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+   Function: draw_wall_column
+
+Description: Draws one vertical column of a wall, shading it by placing a point
+             of the primary color at every "shading_offset"th pixel and filling
+             the rest with black. When the frame buffer has been captured (see
+             "capture_frame_buffer"), the column is written straight into it;
+             otherwise, it's plotted pixel by pixel via the graphics context
+             (or, if every point is colored, as a single line).
+
+     Inputs: ctx            - Pointer to the relevant graphics context.
+             x              - Horizontal coordinate of the column.
+             top            - Topmost point of the column (with respect to the
+                              graphics frame).
+             bottom         - Point just below the column's lowest point.
+             shading_offset - Vertical distance between colored points.
+             phase          - Offset added to each point's vertical coordinate
+                              before testing it against "shading_offset".
+             color          - Primary (i.e., non-black) color of the column.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_wall_column(GContext *ctx,
+                      const int16_t x,
+                      int16_t top,
+                      int16_t bottom,
+                      const int16_t shading_offset,
+                      const int16_t phase,
+                      const GColor color) {
+  int16_t y, countdown;
+  uint8_t *pixel;
+#ifdef PBL_BW
+  const uint8_t bit = 1 << (x % 8);
+#endif
+
+  if (x < 0 || x >= GRAPHICS_FRAME_WIDTH) {
+    return;
+  }
+  if (g_frame_buffer == NULL) {
+    if (shading_offset == 1) {  // Flat-filled, so a single line will do.
+      graphics_context_set_stroke_color(ctx, color);
+      graphics_draw_line(ctx,
+                         GPoint(x, top + STATUS_BAR_HEIGHT),
+                         GPoint(x, bottom - 1 + STATUS_BAR_HEIGHT));
+
+      return;
+    }
+    for (y = top; y < bottom; ++y) {
+      graphics_context_set_stroke_color(ctx,
+                                        (y + phase) % shading_offset == 0 ?
+                                          color                          :
+                                          GColorBlack);
+      graphics_draw_pixel(ctx, GPoint(x, y + STATUS_BAR_HEIGHT));
+    }
+
+    return;
+  }
+
+  // Clip the column to the screen (or, if round, its visible part), then
+  // find its first colored point:
+  if (top < FRAME_BUFFER_COLUMN_TOP(x) - STATUS_BAR_HEIGHT) {
+    top = FRAME_BUFFER_COLUMN_TOP(x) - STATUS_BAR_HEIGHT;
+  }
+  if (bottom > FRAME_BUFFER_COLUMN_BOTTOM(x) - STATUS_BAR_HEIGHT) {
+    bottom = FRAME_BUFFER_COLUMN_BOTTOM(x) - STATUS_BAR_HEIGHT;
+  }
+  countdown = (top + phase) % shading_offset;
+  if (countdown < 0) {
+    countdown += shading_offset;
+  }
+  if (countdown > 0) {
+    countdown = shading_offset - countdown;
+  }
+
+  // Now, write the whole span, one row at a time:
+#ifdef PBL_COLOR
+  pixel = FRAME_BUFFER_ROW(top + STATUS_BAR_HEIGHT) + x;
+#else
+  pixel = FRAME_BUFFER_ROW(top + STATUS_BAR_HEIGHT) + x / 8;
+#endif
+  for (y = top; y < bottom; ++y) {
+#ifdef PBL_ROUND
+    pixel = FRAME_BUFFER_ROW(y + STATUS_BAR_HEIGHT) + x;
+#endif
+    if (countdown == 0) {
+#ifdef PBL_COLOR
+      *pixel = color.argb;
+#else
+      *pixel |= bit;
+#endif
+      countdown = shading_offset;
+    } else {
+#ifdef PBL_COLOR
+      *pixel = GColorBlack.argb;
+#else
+      *pixel &= ~bit;
+#endif
+    }
+    countdown--;
+#ifndef PBL_ROUND
+    pixel += g_frame_buffer_row_size;
+#endif
+  }
+  DRAW_STATS_ADD(direct_pixels, y - top);
+}
+
+/*******************************************************************************
+   Function: draw_textured_wall_column
+
+Description: Draws one vertical column of a wall by copying a column of the
+             matching mip of "g_wall_texture" (stretched to fit, for side
+             walls nearer than the mip's depth) and coloring it with that
+             depth's palette. When the frame buffer has been captured, the
+             column is written straight into it; otherwise, it's plotted pixel
+             by pixel via the graphics context. Either way, only the part
+             within the graphics frame is drawn.
+
+     Inputs: ctx            - Pointer to the relevant graphics context.
+             x              - Horizontal coordinate of the column.
+             top            - Topmost point of the column (with respect to the
+                              graphics frame), which may lie above it.
+             bottom         - Point just below the column's lowest point
+                              (which may lie below the graphics frame).
+             depth          - Depth whose mip is to be used.
+             texture_column - Column within a cell's worth of that mip's
+                              texels (i.e., two tiles' worth).
+
+    Outputs: None.
+*******************************************************************************/
+void draw_textured_wall_column(GContext *ctx,
+                               const int16_t x,
+                               int16_t top,
+                               int16_t bottom,
+                               const int8_t depth,
+                               const int16_t texture_column) {
+  int16_t y, row, first_row = 0, end_row = GRAPHICS_FRAME_HEIGHT;
+  int32_t v, step, tile_height;
+  uint8_t *pixel, texel;
+  const uint8_t *texels;
+  const GColor *palette = g_wall_texture.palettes[depth];
+#ifdef PBL_BW
+  const uint8_t bit = 1 << (x % 8);
+  uint8_t white_texels = 0;  // One bit per texel type.
+#endif
+
+  if (x < 0 || x >= GRAPHICS_FRAME_WIDTH || bottom <= top) {
+    return;
+  }
+  texels = g_wall_texture.mips[depth] +
+             (texture_column % g_wall_texture.tile_widths[depth]) *
+             ((g_wall_texture.tile_heights[depth] + 3) / 4);
+  tile_height = (int32_t) g_wall_texture.tile_heights[depth] <<
+                  FIXED_POINT_SHIFT;
+  step = 2 * tile_height / (bottom - top);  // A cell is two tiles high.
+  v = 0;
+
+  // Clip the column to the graphics frame (and, if round, the screen's visible
+  // part):
+  if (g_frame_buffer != NULL &&
+      first_row < FRAME_BUFFER_COLUMN_TOP(x) - STATUS_BAR_HEIGHT) {
+    first_row = FRAME_BUFFER_COLUMN_TOP(x) - STATUS_BAR_HEIGHT;
+  }
+  if (g_frame_buffer != NULL &&
+      end_row > FRAME_BUFFER_COLUMN_BOTTOM(x) - STATUS_BAR_HEIGHT) {
+    end_row = FRAME_BUFFER_COLUMN_BOTTOM(x) - STATUS_BAR_HEIGHT;
+  }
+  if (top < first_row) {
+    v = (step * (first_row - top)) % tile_height;
+    top = first_row;
+  }
+  if (bottom > end_row) {
+    bottom = end_row;
+  }
+  if (g_frame_buffer == NULL) {
+    for (y = top; y < bottom; ++y) {
+      row = v >> FIXED_POINT_SHIFT;
+      texel = (texels[row / 4] >> ((row % 4) * 2)) & 3;
+      graphics_context_set_stroke_color(ctx, palette[texel]);
+      graphics_draw_pixel(ctx, GPoint(x, y + STATUS_BAR_HEIGHT));
+      v += step;
+      if (v >= tile_height) {  // (Steps are about a texel, so this suffices.)
+        v -= tile_height;
+      }
+    }
+
+    return;
+  }
+
+  // Now, copy the texels, one row at a time:
+#ifdef PBL_COLOR
+  pixel = FRAME_BUFFER_ROW(top + STATUS_BAR_HEIGHT) + x;
+#else
+  for (texel = 0; texel < NUM_TEXEL_TYPES; ++texel) {
+    if (gcolor_equal(palette[texel], GColorWhite)) {
+      white_texels |= 1 << texel;
+    }
+  }
+  pixel = FRAME_BUFFER_ROW(top + STATUS_BAR_HEIGHT) + x / 8;
+#endif
+  for (y = top; y < bottom; ++y) {
+#ifdef PBL_ROUND
+    pixel = FRAME_BUFFER_ROW(y + STATUS_BAR_HEIGHT) + x;
+#endif
+    row = v >> FIXED_POINT_SHIFT;
+    texel = (texels[row / 4] >> ((row % 4) * 2)) & 3;
+#ifdef PBL_COLOR
+    *pixel = palette[texel].argb;
+#else
+    if ((white_texels >> texel) & 1) {
+      *pixel |= bit;
+    } else {
+      *pixel &= ~bit;
+    }
+#endif
+    v += step;
+    if (v >= tile_height) {
+      v -= tile_height;
+    }
+#ifndef PBL_ROUND
+    pixel += g_frame_buffer_row_size;
+#endif
+  }
+  DRAW_STATS_ADD(direct_pixels, y - top);
+}
+
+#ifdef PBL_BW
+/*******************************************************************************
+   Function: draw_wall_rows
+
+Description: Draws a uniformly shaded (i.e., back) wall directly into the 1-bit
+             frame buffer, 32 pixels at a time. Even and odd columns share the
+             same pattern as "draw_wall", so each row is one of four masks.
+
+     Inputs: left   - Leftmost column of the wall.
+             right  - Rightmost column of the wall.
+             top    - Topmost row of the wall (with respect to the graphics
+                      frame).
+             bottom - Row just below the wall's lowest row.
+             flat   - Whether to color every point instead of shading.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_wall_rows(int16_t left,
+                    int16_t right,
+                    int16_t top,
+                    int16_t bottom,
+                    const bool flat) {
+  int16_t y, shading_offset, half_shading_offset;
+  uint32_t pattern;
+
+  // Determine vertical distance between points (every point being colored
+  // when walls are flat-filled):
+  shading_offset = flat ? 1 : g_shading_offsets[top];
+  half_shading_offset = (shading_offset / 2) + (shading_offset % 2);
+
+  // Clip the wall to the graphics frame, then draw it row by row:
+  if (left < 0) {
+    left = 0;
+  }
+  if (right >= GRAPHICS_FRAME_WIDTH) {
+    right = GRAPHICS_FRAME_WIDTH - 1;
+  }
+  if (top < -STATUS_BAR_HEIGHT) {
+    top = -STATUS_BAR_HEIGHT;
+  }
+  if (bottom > SCREEN_HEIGHT - STATUS_BAR_HEIGHT) {
+    bottom = SCREEN_HEIGHT - STATUS_BAR_HEIGHT;
+  }
+  for (y = top; y < bottom && left <= right; ++y) {
+    pattern = 0;
+    if (y % shading_offset == 0) {
+      pattern |= EVEN_COLUMNS_MASK;
+    }
+    if ((y + half_shading_offset) % shading_offset == 0) {
+      pattern |= ODD_COLUMNS_MASK;
+    }
+    write_frame_buffer_row(y + STATUS_BAR_HEIGHT, left, right, pattern);
+  }
+}
+
+/*******************************************************************************
+   Function: draw_dotted_row
+
+Description: Adds evenly spaced white points to a row of the 1-bit frame buffer,
+             32 pixels at a time, using the precomputed "g_dither_masks".
+
+     Inputs: y       - Screen row of interest.
+             first_x - Horizontal coordinate of the leftmost point.
+             spacing - Horizontal distance between points.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_dotted_row(const int16_t y,
+                     const int16_t first_x,
+                     const int16_t spacing) {
+  int16_t i, shift;
+  uint32_t *row, span;
+
+  if (y < 0 || y >= SCREEN_HEIGHT || spacing > MAX_SHADING_OFFSET) {
+    return;
+  }
+  row = (uint32_t *) (g_frame_buffer_data + y * g_frame_buffer_row_size);
+  shift = first_x % spacing;
+  for (i = first_x / 32; i <= (GRAPHICS_FRAME_WIDTH - 1) / 32; ++i) {
+    span = ~0u;
+    if (i == first_x / 32) {
+      span &= ~0u << (first_x % 32);
+    }
+    if (i == (GRAPHICS_FRAME_WIDTH - 1) / 32) {
+      span &= ~0u >> (31 - (GRAPHICS_FRAME_WIDTH - 1) % 32);
+    }
+    row[i] |= (g_dither_masks[spacing] << shift) & span;
+
+    // Determine where the first point of the next word falls:
+    shift = (shift - 32 % spacing + spacing) % spacing;
+  }
+  DRAW_STATS_ADD(direct_pixels,
+                 (GRAPHICS_FRAME_WIDTH - first_x + spacing - 1) / spacing);
+}
+
+/*******************************************************************************
+   Function: write_frame_buffer_row
+
+Description: Overwrites a horizontal span of the 1-bit frame buffer with a given
+             bit pattern, 32 pixels at a time.
+
+     Inputs: y       - Screen row of interest.
+             left    - Leftmost column of the span.
+             right   - Rightmost column of the span.
+             pattern - Bit pattern to be written (bit "n" of each word
+                       corresponds to column "32 * word_index + n").
+
+    Outputs: None.
+*******************************************************************************/
+void write_frame_buffer_row(const int16_t y,
+                            const int16_t left,
+                            const int16_t right,
+                            const uint32_t pattern) {
+  int16_t i;
+  uint32_t *row, span;
+
+  row = (uint32_t *) (g_frame_buffer_data + y * g_frame_buffer_row_size);
+  for (i = left / 32; i <= right / 32; ++i) {
+    span = ~0u;
+    if (i == left / 32) {
+      span &= ~0u << (left % 32);
+    }
+    if (i == right / 32) {
+      span &= ~0u >> (31 - right % 32);
+    }
+    span &= ~g_column_coverage[i];  // Leave hidden columns untouched.
+    row[i] = (row[i] & ~span) | (pattern & span);
+  }
+  DRAW_STATS_ADD(direct_pixels, right - left + 1);
+}
+
+/*******************************************************************************
+   Function: init_dither_masks
+
+Description: Initializes the global "g_dither_masks" array so that, for each
+             shading offset, it contains a 32-bit mask with every
+             "shading_offset"th bit set (starting with bit zero).
+
+     Inputs: None.
+
+    Outputs: None.
+*******************************************************************************/
+void init_dither_masks(void) {
+  int16_t i, j;
+
+  for (i = 1; i <= MAX_SHADING_OFFSET; ++i) {
+    g_dither_masks[i] = 0;
+    for (j = 0; j < 32; j += i) {
+      g_dither_masks[i] |= 1u << j;
+    }
+  }
+}
+#endif
+
+/*******************************************************************************
+   Function: draw_frame_buffer_pixel
+
+Description: Writes a single pixel directly into the captured frame buffer.
+
+     Inputs: x     - Horizontal screen coordinate.
+             y     - Vertical screen coordinate.
+             color - Desired color.
+
+    Outputs: None.
+*******************************************************************************/
+void draw_frame_buffer_pixel(const int16_t x,
+                             const int16_t y,
+                             const GColor color) {
+  if (y < 0 ||
+      y >= SCREEN_HEIGHT ||
+      x < FRAME_BUFFER_ROW_LEFT(y) ||
+      x > FRAME_BUFFER_ROW_RIGHT(y)) {
+    return;
   }
-
-  // Finally, update the lower status bar:
-  update_status_bar(ctx);
+  DRAW_STATS_ADD(direct_pixels, 1);
+#ifdef PBL_COLOR
+  FRAME_BUFFER_ROW(y)[x] = color.argb;
+#else
+  if (gcolor_equal(color, GColorWhite)) {
+    g_frame_buffer_data[y * g_frame_buffer_row_size + x / 8] |= 1 << (x % 8);
+  } else {
+    g_frame_buffer_data[y * g_frame_buffer_row_size + x / 8] &=
+      ~(1 << (x % 8));
+  }
+#endif
 }
 
 /*******************************************************************************
-   Function: draw_floor_and_ceiling
+   Function: draw_line_segment
 
-Description: Draws the floor and ceiling.
+Description: Draws a line segment of a given color, writing it straight into the
+             frame buffer if it has been captured (see "capture_frame_buffer")
+             or drawing it via the graphics context otherwise.
 
-     Inputs: ctx - Pointer to the relevant graphics context.
+     Inputs: ctx   - Pointer to the relevant graphics context.
+             start - Screen coordinates of one end of the line segment.
+             end   - Screen coordinates of the other end.
+             color - Desired color.
 
     Outputs: None.
 *******************************************************************************/
-void draw_floor_and_ceiling(GContext *ctx) {
-  uint8_t x, y, max_y, shading_offset;
+void draw_line_segment(GContext *ctx,
+                       const GPoint start,
+                       const GPoint end,
+                       const GColor color) {
+  int16_t x, y, dx, dy, x_step, y_step, error, double_error;
 
-  max_y = g_back_wall_coords[MAX_VISIBILITY_DEPTH - 2][0][TOP_LEFT].y;
-#ifdef PBL_BW
-  graphics_context_set_stroke_color(ctx, GColorWhite);
-#endif
-  for (y = 0; y < max_y; ++y) {
-    // Determine horizontal distance between points:
-    shading_offset = 1 + y / MAX_VISIBILITY_DEPTH;
-    if (y % MAX_VISIBILITY_DEPTH >= MAX_VISIBILITY_DEPTH / 2 +
-                                    MAX_VISIBILITY_DEPTH % 2) {
-      shading_offset++;
+  if (g_frame_buffer == NULL) {
+    graphics_context_set_stroke_color(ctx, color);
+    graphics_draw_line(ctx, start, end);
+
+    return;
+  }
+
+  // Bresenham's algorithm:
+  dx = start.x < end.x ? end.x - start.x : start.x - end.x;
+  dy = start.y < end.y ? start.y - end.y : end.y - start.y;
+  x_step = start.x < end.x ? 1 : -1;
+  y_step = start.y < end.y ? 1 : -1;
+  error = dx + dy;
+  x = start.x;
+  y = start.y;
+  for (;;) {
+    if (x < 0 || x >= GRAPHICS_FRAME_WIDTH || !COLUMN_IS_COVERED(x) ||
+        y < g_covered_tops[x] + STATUS_BAR_HEIGHT ||
+        y >= g_covered_bottoms[x] + STATUS_BAR_HEIGHT) {
+      draw_frame_buffer_pixel(x, y, color);  // (Not hidden by a nearer wall.)
     }
-#ifdef PBL_COLOR
-    graphics_context_set_stroke_color(ctx,
-      g_background_colors[g_maze->floor_color_scheme]
-                         [shading_offset > NUM_BACKGROUND_COLORS_PER_SCHEME ?
-                            NUM_BACKGROUND_COLORS_PER_SCHEME - 1            :
-                            shading_offset - 1]);
-#endif
-    for (x = y % 2 ? 0 : (shading_offset / 2) + (shading_offset % 2);
-         x < GRAPHICS_FRAME_WIDTH;
-         x += shading_offset) {
-      // Draw one point on the ceiling and another on the floor:
-      graphics_draw_pixel(ctx, GPoint(x, y + STATUS_BAR_HEIGHT));
-      graphics_draw_pixel(ctx, GPoint(x, GRAPHICS_FRAME_HEIGHT - y +
-                                           STATUS_BAR_HEIGHT));
+    if (x == end.x && y == end.y) {
+      break;
+    }
+    double_error = 2 * error;
+    if (double_error >= dy) {
+      error += dy;
+      x += x_step;
+    }
+    if (double_error <= dx) {
+      error += dx;
+      y += y_step;
     }
   }
 }
 
 /*******************************************************************************
-   Function: draw_cell_contents
+   Function: capture_frame_buffer
 
-Description: Draws walls and other contents for a given cell.
+Description: Captures the frame buffer so walls and lines can be written
+             directly into it rather than one pixel at a time via the graphics
+             context. (No other drawing functions may be called until the frame
+             buffer is released via "release_frame_buffer".)
 
-     Inputs: ctx         - Pointer to the relevant graphics context.
-             cell_coords - Coordinates of the cell of interest in "g_maze".
-             depth       - Front-back visual depth of the cell of interest in
-                           "g_back_wall_coords".
-             position    - Left-right visual position of the cell of interest
-                           in "g_back_wall_coords".
-
-    Outputs: "True" unless the cell is located entirely off-screen.
-*******************************************************************************/
-bool draw_cell_contents(GContext *ctx,
-                        const GPoint cell_coords,
-                        const int8_t depth,
-                        const int8_t position) {
-  int16_t left, right, top, bottom, y_offset;
-  GPoint cell_coords2;
-  bool back_wall_drawn, left_wall_drawn, right_wall_drawn;
-
-  if (is_solid(cell_coords) ||
-      depth <  0 ||
-      depth >= MAX_VISIBILITY_DEPTH - 1 ||
-      position <  0 ||
-      position >  STRAIGHT_AHEAD * 2) {
-    return false;
-  }
+     Inputs: ctx - Pointer to the relevant graphics context.
 
-  // Back wall:
-  left = g_back_wall_coords[depth][position][TOP_LEFT].x;
-  right = g_back_wall_coords[depth][position][BOTTOM_RIGHT].x;
-  top = g_back_wall_coords[depth][position][TOP_LEFT].y;
-  bottom = g_back_wall_coords[depth][position][BOTTOM_RIGHT].y;
-  if (bottom - top < MIN_WALL_HEIGHT) {
+    Outputs: Returns "true" if the frame buffer was successfully captured.
+*******************************************************************************/
+bool capture_frame_buffer(GContext *ctx) {
+  g_frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (g_frame_buffer == NULL) {
     return false;
   }
-  back_wall_drawn = left_wall_drawn = right_wall_drawn = false;
-  cell_coords2 = get_cell_farther_away(cell_coords,
-                                       g_player->direction,
-                                       1);
-  if (is_solid(cell_coords2)) {
-    draw_wall(ctx,
-              GPoint(left, top),
-              GPoint(left, bottom),
-              GPoint(right, top),
-              GPoint(right, bottom));
-    back_wall_drawn = true;
-  }
-
-  // Left wall:
-  right = left;
-  if (depth == 0) {
-    left = 0;
-    y_offset = top;
-  } else {
-    left = g_back_wall_coords[depth - 1][position][TOP_LEFT].x;
-    y_offset = top - g_back_wall_coords[depth - 1][position][TOP_LEFT].y;
-  }
-  if (position <= STRAIGHT_AHEAD) {
-    cell_coords2 = get_cell_to_the_left(cell_coords,
-                                        g_player->direction,
-                                        1);
-    if (is_solid(cell_coords2)) {
-      draw_wall(ctx,
-                GPoint(left, top - y_offset),
-                GPoint(left, bottom + y_offset),
-                GPoint(right, top),
-                GPoint(right, bottom));
-      left_wall_drawn = true;
-    }
-  }
-
-  // Right wall:
-  left = g_back_wall_coords[depth][position][BOTTOM_RIGHT].x;
-  if (depth == 0) {
-    right = GRAPHICS_FRAME_WIDTH - 1;
-  } else {
-    right = g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].x;
-  }
-  if (position >= STRAIGHT_AHEAD) {
-    cell_coords2 = get_cell_to_the_right(cell_coords,
-                                         g_player->direction,
-                                         1);
-    if (is_solid(cell_coords2)) {
-      draw_wall(ctx,
-                GPoint(left, top),
-                GPoint(left, bottom),
-                GPoint(right, top - y_offset),
-                GPoint(right, bottom + y_offset));
-      right_wall_drawn = true;
-    }
-  }
-
-  // Draw vertical lines at corners:
-  graphics_context_set_stroke_color(ctx, GColorBlack);
-  cell_coords2 = get_cell_farther_away(cell_coords,
-                                       g_player->direction,
-                                       1);
-  if ((back_wall_drawn && (left_wall_drawn ||
-       !is_solid(get_cell_to_the_left(cell_coords2,
-                                      g_player->direction,
-                                      1)))) ||
-      (left_wall_drawn &&
-       !is_solid(get_cell_to_the_left(cell_coords2,
-                                      g_player->direction,
-                                      1)))) {
-    graphics_draw_line(ctx,
-                       GPoint(g_back_wall_coords[depth][position][TOP_LEFT].x,
-                              g_back_wall_coords[depth][position][TOP_LEFT].y +
-                                STATUS_BAR_HEIGHT),
-                       GPoint(g_back_wall_coords[depth][position][TOP_LEFT].x,
-                           g_back_wall_coords[depth][position][BOTTOM_RIGHT].y +
-                             STATUS_BAR_HEIGHT));
-  }
-  if ((back_wall_drawn && (right_wall_drawn ||
-       !is_solid(get_cell_to_the_right(cell_coords2,
-                                       g_player->direction,
-                                       1)))) ||
-      (right_wall_drawn &&
-       !is_solid(get_cell_to_the_right(cell_coords2,
-                                       g_player->direction,
-                                       1)))) {
-    graphics_draw_line(ctx,
-                   GPoint(g_back_wall_coords[depth][position][BOTTOM_RIGHT].x,
-                          g_back_wall_coords[depth][position][BOTTOM_RIGHT].y +
-                            STATUS_BAR_HEIGHT),
-                   GPoint(g_back_wall_coords[depth][position][BOTTOM_RIGHT].x,
-                          g_back_wall_coords[depth][position][TOP_LEFT].y +
-                            STATUS_BAR_HEIGHT));
-  }
-
-  // Entrance/exit markers:
-  if (get_cell_type(cell_coords) == ENTRANCE) {
-    draw_entrance(ctx, depth, position);
-  }
-  else if (get_cell_type(cell_coords) == EXIT) {
-    draw_exit(ctx, depth, position);
-  }
+  set_frame_buffer(g_frame_buffer);
 
   return true;
 }
 
 /*******************************************************************************
-   Function: draw_wall
+   Function: set_frame_buffer
 
-Description: Draws a wall according to specifications.
+Description: Points the direct-drawing functions at a given bitmap (either the
+             captured frame buffer or the backdrop). A round display's rows
+             vary in length, so there the start and visible columns of each
+             row, and the visible rows of each column, are also noted (unless
+             already known), letting walls skip the masked-off corners.
 
-     Inputs: ctx         - Pointer to the relevant graphics context.
-             upper_left  - Coordinates for the wall's upper-left point.
-             lower_left  - Coordinates for the wall's lower-left point.
-             upper_right - Coordinates for the wall's upper-right point.
-             lower_right - Coordinates for the wall's lower-right point.
+     Inputs: bitmap - Pointer to the bitmap to be drawn into.
 
-    Outputs: "True" if the wall is successfully drawn on the screen (i.e., the
-             wall isn't located entirely off-screen).
+    Outputs: None.
 *******************************************************************************/
-bool draw_wall(GContext *ctx,
-               const GPoint upper_left,
-               const GPoint lower_left,
-               const GPoint upper_right,
-               const GPoint lower_right) {
-  int16_t i, j, shading_offset, half_shading_offset;
-  float dy_over_dx = (float) (upper_right.y - upper_left.y) /
-                             (upper_right.x - upper_left.x);
-  GColor primary_color = GColorWhite;
-
-  for (i = upper_left.x; i <= upper_right.x && i < GRAPHICS_FRAME_WIDTH; ++i) {
-    // Determine vertical distance between points:
-    shading_offset = 1 + ((upper_left.y + (i - upper_left.x) * dy_over_dx) /
-                          MAX_VISIBILITY_DEPTH);
-    if ((int16_t) (upper_left.y + (i - upper_left.x) * dy_over_dx) %
-        MAX_VISIBILITY_DEPTH >= MAX_VISIBILITY_DEPTH / 2 +
-                                MAX_VISIBILITY_DEPTH % 2) {
-      shading_offset++;
-    }
-    half_shading_offset = (shading_offset / 2) + (shading_offset % 2);
-#ifdef PBL_COLOR
-    primary_color = g_background_colors[g_maze->wall_color_scheme]
-                      [shading_offset > NUM_BACKGROUND_COLORS_PER_SCHEME ?
-                         NUM_BACKGROUND_COLORS_PER_SCHEME - 1            :
-                         shading_offset - 1];
+void set_frame_buffer(GBitmap *const bitmap) {
+#ifdef PBL_ROUND
+  int16_t x, y;
+  GBitmapDataRowInfo row_info;
+  const int16_t height = gbitmap_get_bounds(bitmap).size.h;
 #endif
 
-    // Now, draw points from top to bottom:
-    for (j = upper_left.y + (i - upper_left.x) * dy_over_dx;
-         j < lower_left.y - (i - upper_left.x) * dy_over_dx;
-         ++j) {
-      if ((j + (int16_t) ((i - upper_left.x) * dy_over_dx) +
-          (i % 2 == 0 ? 0 : half_shading_offset)) % shading_offset == 0) {
-        graphics_context_set_stroke_color(ctx, primary_color);
-      } else {
-        graphics_context_set_stroke_color(ctx, GColorBlack);
+  g_frame_buffer = bitmap;
+  g_frame_buffer_data = gbitmap_get_data(bitmap);
+  g_frame_buffer_row_size = gbitmap_get_bytes_per_row(bitmap);
+#ifdef PBL_ROUND
+  if (bitmap == g_frame_buffer_layout &&
+      g_frame_buffer_rows[0] == gbitmap_get_data_row_info(bitmap, 0).data) {
+    return;
+  }
+  for (x = 0; x < SCREEN_WIDTH; ++x) {
+    g_frame_buffer_column_tops[x] = SCREEN_HEIGHT;
+    g_frame_buffer_column_bottoms[x] = 0;
+  }
+  for (y = 0; y < SCREEN_HEIGHT; ++y) {
+    if (y >= height) {  // (The backdrop is shorter than the screen.)
+      g_frame_buffer_rows[y] = NULL;
+      g_frame_buffer_row_lefts[y] = 0;
+      g_frame_buffer_row_rights[y] = -1;
+      continue;
+    }
+    row_info = gbitmap_get_data_row_info(bitmap, y);
+    g_frame_buffer_rows[y] = row_info.data;
+    g_frame_buffer_row_lefts[y] = row_info.min_x;
+    g_frame_buffer_row_rights[y] = row_info.max_x;
+    for (x = row_info.min_x; x <= row_info.max_x; ++x) {
+      if (g_frame_buffer_column_tops[x] > y) {
+        g_frame_buffer_column_tops[x] = y;
       }
-      graphics_draw_pixel(ctx, GPoint(i, j + STATUS_BAR_HEIGHT));
+      g_frame_buffer_column_bottoms[x] = y + 1;
     }
   }
+  g_frame_buffer_layout = bitmap;
+#endif
+}
 
-  // Draw lines along the top and bottom of the wall:
-  graphics_context_set_stroke_color(ctx, GColorBlack);
-  graphics_draw_line(ctx,
-                     GPoint(upper_left.x, upper_left.y + STATUS_BAR_HEIGHT),
-                     GPoint(upper_right.x, upper_right.y + STATUS_BAR_HEIGHT));
-  graphics_draw_line(ctx,
-                     GPoint(lower_left.x, lower_left.y + STATUS_BAR_HEIGHT),
-                     GPoint(lower_right.x, lower_right.y + STATUS_BAR_HEIGHT));
+/*******************************************************************************
+   Function: release_frame_buffer
 
-  // Ad hoc solution to a minor visual issue (remove if no longer relevant):
-  if (upper_left.y == g_back_wall_coords[1][0][TOP_LEFT].y) {
-    graphics_draw_line(ctx,
-                       GPoint(lower_left.x,
-                              lower_left.y + 1 + STATUS_BAR_HEIGHT),
-                       GPoint(lower_right.x,
-                              lower_right.y + 1 + STATUS_BAR_HEIGHT));
-  }
+Description: Releases the frame buffer, if captured, so the graphics context may
+             be used again.
 
-  return true;
+     Inputs: ctx - Pointer to the relevant graphics context.
+
+    Outputs: None.
+*******************************************************************************/
+void release_frame_buffer(GContext *ctx) {
+  if (g_frame_buffer != NULL) {
+    graphics_release_frame_buffer(ctx, g_frame_buffer);
+    g_frame_buffer = NULL;
+  }
 }
 
 /*******************************************************************************
@@ -1019,24 +3806,9 @@ Description: Draws an entrance graphic on the ceiling of a given cell location.
              the entrance isn't located entirely off-screen).
 *******************************************************************************/
 bool draw_entrance(GContext *ctx, const int8_t depth, const int8_t position) {
-  uint8_t h_radius, v_radius;  // Horizontal and vertical radii for an ellipse.
-
-  h_radius = ELLIPSE_RADIUS_RATIO *
-               (g_back_wall_coords[depth][position][BOTTOM_RIGHT].x -
-                g_back_wall_coords[depth][position][TOP_LEFT].x);
-  if (depth == 0) {
-    v_radius = ELLIPSE_RADIUS_RATIO *
-                 g_back_wall_coords[depth][position][TOP_LEFT].y;
-  } else {
-    v_radius = ELLIPSE_RADIUS_RATIO *
-                 (g_back_wall_coords[depth][position][TOP_LEFT].y -
-                  g_back_wall_coords[depth - 1][position][TOP_LEFT].y);
-  }
-
   return fill_ellipse(ctx,
                       get_ceiling_center_point(depth, position),
-                      h_radius,
-                      v_radius,
+                      depth,
                       GColorBlack);
 }
 
@@ -1055,50 +3827,43 @@ Description: Draws an exit graphic on the floor of a given cell location.
              exit isn't located entirely off-screen).
 *******************************************************************************/
 bool draw_exit(GContext *ctx, const int8_t depth, const int8_t position) {
-  uint8_t h_radius, v_radius;  // Horizontal and vertical radii for an ellipse.
-
-  h_radius = ELLIPSE_RADIUS_RATIO *
-               (g_back_wall_coords[depth][position][BOTTOM_RIGHT].x -
-                g_back_wall_coords[depth][position][TOP_LEFT].x);
-  if (depth == 0) {
-    v_radius = ELLIPSE_RADIUS_RATIO *
-                 (GRAPHICS_FRAME_HEIGHT -
-                  g_back_wall_coords[depth][position][BOTTOM_RIGHT].y);
-  } else {
-    v_radius = ELLIPSE_RADIUS_RATIO *
-                 (g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].y -
-                  g_back_wall_coords[depth][position][BOTTOM_RIGHT].y);
-  }
-
   return fill_ellipse(ctx,
                       get_floor_center_point(depth, position),
-                      h_radius,
-                      v_radius,
+                      depth,
                       GColorBlack);
 }
 
 /*******************************************************************************
    Function: fill_ellipse
 
-Description: Draws a filled ellipse according to given specifications.
+Description: Draws a filled entrance/exit ellipse one row at a time, taking its
+             radii and the half-width of each row from the precomputed
+             "g_ellipse_radii" and "g_ellipse_half_widths" tables. Each row is
+             drawn exactly once.
 
-     Inputs: ctx      - Pointer to the relevant graphics context.
-             center   - Central coordinates of the ellipse (with respect to the
-                        graphics frame).
-             h_radius - Horizontal radius.
-             v_radius - Vertical radius.
-             color    - Desired color.
+     Inputs: ctx    - Pointer to the relevant graphics context.
+             center - Central coordinates of the ellipse (with respect to the
+                      graphics frame).
+             depth  - Front-back visual depth of the ellipse's cell in
+                      "g_back_wall_coords" (which determines its size).
+             color  - Desired color.
 
     Outputs: Returns "true" if the ellipse is successfully drawn on the screen
              (i.e., the ellipse isn't located entirely off-screen).
 *******************************************************************************/
 bool fill_ellipse(GContext *ctx,
                   const GPoint center,
-                  const uint8_t h_radius,
-                  const uint8_t v_radius,
+                  const int8_t depth,
                   const GColor color) {
-  int16_t theta;
-  uint8_t x_offset, y_offset;
+  int16_t dy, half_width;
+#ifdef FLOAT_PROJECTION
+  const GSize radii = get_float_ellipse_radii(depth);
+  const int16_t h_radius = radii.w,
+                v_radius = radii.h;
+#else
+  const int16_t h_radius = g_ellipse_radii[depth].w,
+                v_radius = g_ellipse_radii[depth].h;
+#endif
 
   if (center.x + h_radius < 0 ||
       center.x - h_radius >= GRAPHICS_FRAME_WIDTH ||
@@ -1107,20 +3872,18 @@ bool fill_ellipse(GContext *ctx,
     return false;
   }
 
-  graphics_context_set_stroke_color(ctx, color);
-  for (theta = 0; theta < NINETY_DEGREES; theta += DEFAULT_ROTATION_RATE) {
-    x_offset = cos_lookup(theta) * h_radius / TRIG_MAX_RATIO;
-    y_offset = sin_lookup(theta) * v_radius / TRIG_MAX_RATIO;
-    graphics_draw_line(ctx,
-                       GPoint(center.x - x_offset,
-                              center.y - y_offset + STATUS_BAR_HEIGHT),
-                       GPoint(center.x + x_offset,
-                              center.y - y_offset + STATUS_BAR_HEIGHT));
-    graphics_draw_line(ctx,
-                       GPoint(center.x - x_offset,
-                              center.y + y_offset + STATUS_BAR_HEIGHT),
-                       GPoint(center.x + x_offset,
-                              center.y + y_offset + STATUS_BAR_HEIGHT));
+  for (dy = 1 - v_radius; dy < v_radius; ++dy) {
+#ifdef FLOAT_PROJECTION
+    half_width = get_ellipse_half_width(h_radius, v_radius, dy);
+#else
+    half_width = g_ellipse_half_widths[depth][dy < 0 ? -dy : dy];
+#endif
+    draw_line_segment(ctx,
+                      GPoint(center.x - half_width,
+                             center.y + dy + STATUS_BAR_HEIGHT),
+                      GPoint(center.x + half_width,
+                             center.y + dy + STATUS_BAR_HEIGHT),
+                      color);
   }
 
   return true;
@@ -1155,15 +3918,17 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
   int8_t new_achievement_index;  // To check for pending achievement messages.
 
   if (!g_game_paused) {
-    g_maze->seconds++;
-    if (g_maze->seconds > MAX_SECONDS) {
-      g_maze->seconds = MAX_SECONDS;
-      if (!g_player->achievement_unlocked[ONE_HOUR_ACHIEVEMENT]) {
-        g_player->achievement_unlocked[ONE_HOUR_ACHIEVEMENT] = true;
-        g_new_achievement_unlocked[ONE_HOUR_ACHIEVEMENT] = true;
+    if (!g_endless.enabled) {  // (The maze's clock stops while away from it.)
+      g_maze->seconds++;
+      if (g_maze->seconds > MAX_SECONDS) {
+        g_maze->seconds = MAX_SECONDS;
+        if (!g_player->achievement_unlocked[ONE_HOUR_ACHIEVEMENT]) {
+          g_player->achievement_unlocked[ONE_HOUR_ACHIEVEMENT] = true;
+          g_new_achievement_unlocked[ONE_HOUR_ACHIEVEMENT] = true;
+        }
       }
+      update_time_text();  // Only the time text needs to be redrawn.
     }
-    layer_mark_dirty(window_get_root_layer(g_graphics_window));
 
     // Check for pending time/achievement messages:
     if (g_new_best_time > -1) {
@@ -1213,6 +3978,8 @@ Description: Called when the graphics window appears.
 *******************************************************************************/
 static void graphics_window_appear(Window *window) {
   g_game_paused = false;
+  update_level_text();
+  update_time_text();
 }
 
 /*******************************************************************************
@@ -1275,7 +4042,8 @@ void graphics_up_multi_click(ClickRecognizerRef recognizer, void *context) {
         break;
     }
     update_compass();
-    layer_mark_dirty(window_get_root_layer(g_graphics_window));
+    g_scene_dirty = true;
+    layer_mark_dirty(g_scene_layer);
   }
 }
 
@@ -1326,7 +4094,8 @@ void graphics_down_multi_click(ClickRecognizerRef recognizer, void *context) {
         break;
     }
     update_compass();
-    layer_mark_dirty(window_get_root_layer(g_graphics_window));
+    g_scene_dirty = true;
+    layer_mark_dirty(g_scene_layer);
   }
 }
 
@@ -1578,26 +4347,59 @@ static void in_game_menu_draw_row_callback(GContext* ctx,
                            NULL);
       break;
     case 1:
+      menu_cell_basic_draw(ctx,
+                           cell_layer,
+                           "Minimap",
+                           g_minimap.enabled ? "On." : "Off.",
+                           NULL);
+      break;
+    case 2:
+      menu_cell_basic_draw(ctx,
+                           cell_layer,
+                           "Endless",
+                           g_endless.enabled ? "On." : "Off.",
+                           NULL);
+      break;
+    case 3:
       menu_cell_basic_draw(ctx,
                            cell_layer,
                            "Stats",
                            "Your accomplishments.",
                            NULL);
       break;
-    case 2:
+    case 4:
       menu_cell_basic_draw(ctx,
                            cell_layer,
                            "Controls",
                            "Learn how to play.",
                            NULL);
       break;
-    default:
+    case 5:
       menu_cell_basic_draw(ctx,
                            cell_layer,
                            "About",
                            "Credits, etc.",
                            NULL);
       break;
+#ifdef RAYCASTING_ENGINE_ENABLED
+    case 6:
+      menu_cell_basic_draw(ctx,
+                           cell_layer,
+                           "Renderer",
+                           g_render_engine == RAYCASTING_ENGINE ?
+                             "Raycaster." : "Wall grid.",
+                           NULL);
+      break;
+#endif
+#ifdef DRAW_STATS
+    default:  // Only in instrumented builds.
+      menu_cell_basic_draw(ctx,
+                           cell_layer,
+                           "Draw Stats",
+                           "Log recent frames.",
+                           NULL);
+      break;
+#endif
   }
 }
 
@@ -1617,21 +4419,48 @@ void in_game_menu_select_callback(MenuLayer *menu_layer,
                                   void *data) {
   switch (cell_index->row) {
     case 0:  // New Maze
-      init_maze();
+      if (g_endless.enabled) {
+        reset_endless_world();
+      } else {
+        init_maze();
+      }
       window_stack_pop(NOT_ANIMATED);
       break;
-    case 1:  // Stats
+    case 1:  // Minimap
+      g_minimap.enabled = !g_minimap.enabled;
+      layer_set_hidden(g_minimap_layer,
+                       !g_minimap.enabled || g_endless.enabled);
+      window_stack_pop(NOT_ANIMATED);
+      break;
+    case 2:  // Endless
+      set_endless_mode(!g_endless.enabled);
+      window_stack_pop(NOT_ANIMATED);
+      break;
+    case 3:  // Stats
       g_current_narration = STATS_NARRATION;
       show_narration();
       break;
-    case 2:  // Controls
+    case 4:  // Controls
       g_current_narration = CONTROLS_NARRATION;
       show_narration();
       break;
-    default:  // About
+    case 5:  // About
       g_current_narration = GAME_INFO_NARRATION;
       show_narration();
       break;
+#ifdef RAYCASTING_ENGINE_ENABLED
+    case 6:  // Renderer
+      g_render_engine = (g_render_engine + 1) % NUM_RENDER_ENGINES;
+      clear_frame_cache();  // (It isn't keyed by engine.)
+      g_scene_dirty = true;
+      window_stack_pop(NOT_ANIMATED);
+      break;
+#endif
+#ifdef DRAW_STATS
+    default:  // Draw Stats
+      log_draw_stats();
+      break;
+#endif
   }
 }
 
@@ -1693,6 +4522,146 @@ Description: Returns the central point, with respect to the graphics layer, of
 GPoint get_floor_center_point(const int8_t depth, const int8_t position) {
   int16_t x_midpoint1, x_midpoint2, x, y;
 
+#ifdef FLOAT_PROJECTION
+  return get_float_floor_center_point(depth, position);
+#endif
+  x_midpoint1 = (g_back_wall_coords[depth][position][TOP_LEFT].x +
+                 g_back_wall_coords[depth][position][BOTTOM_RIGHT].x) / 2;
+  if (depth == 0) {
+    if (position < STRAIGHT_AHEAD) {  // To the left of the player.
+      x_midpoint2 = -GRAPHICS_FRAME_WIDTH / 2;
+    } else if (position > STRAIGHT_AHEAD) {  // To the right of the player.
+      x_midpoint2 = GRAPHICS_FRAME_WIDTH * 3 / 2;
+    } else {  // Directly under the player.
+      x_midpoint2 = x_midpoint1;
+    }
+    y = GRAPHICS_FRAME_HEIGHT;
+  } else {
+    x_midpoint2 = (g_back_wall_coords[depth - 1][position][TOP_LEFT].x +
+                   g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].x) / 2;
+    y = (g_back_wall_coords[depth][position][BOTTOM_RIGHT].y +
+         g_back_wall_coords[depth - 1][position][BOTTOM_RIGHT].y) / 2;
+  }
+  x = (x_midpoint1 + x_midpoint2) / 2;
+
+  return GPoint(x, y);
+}
+
+#ifdef FLOAT_PROJECTION
+/*******************************************************************************
+   Function: get_float_wall_edges
+
+Description: Reference for "make check-projection" (see "host/Makefile"):
+             computes the top and bottom of a side wall column and the
+             truncated rise of its top edge with the float slope that the Q16
+             "g_side_wall_rises" tables replaced, exactly as "draw_wall" used
+             to.
+
+     Inputs: upper_left     - Coordinates for the wall's upper-left point.
+             lower_left     - Coordinates for the wall's lower-left point.
+             upper_right    - Coordinates for the wall's upper-right point.
+             column         - The column of interest.
+             top            - Where to store the column's top row.
+             bottom         - Where to store the column's bottom row.
+             truncated_rise - Where to store the top edge's rise, rounded
+                              toward zero.
+
+    Outputs: None.
+*******************************************************************************/
+void get_float_wall_edges(const GPoint upper_left,
+                          const GPoint lower_left,
+                          const GPoint upper_right,
+                          const int16_t column,
+                          int16_t *const top,
+                          int16_t *const bottom,
+                          int16_t *const truncated_rise) {
+  const float dy_over_dx = upper_right.x > upper_left.x ?
+                             (float) (upper_right.y - upper_left.y) /
+                               (upper_right.x - upper_left.x) :
+                             0;
+
+  *top = upper_left.y + (column - upper_left.x) * dy_over_dx;
+  *bottom = lower_left.y - (column - upper_left.x) * dy_over_dx;
+  if (*bottom < lower_left.y - (column - upper_left.x) * dy_over_dx) {
+    (*bottom)++;  // Round up, since the bottom boundary is exclusive.
+  }
+  *truncated_rise = (int16_t) ((column - upper_left.x) * dy_over_dx);
+}
+
+/*******************************************************************************
+   Function: get_float_ellipse_radii
+
+Description: Reference for "make check-projection": computes the radii of the
+             entrance and exit ellipses at a given depth with the float ratio
+             that the Q16 "ELLIPSE_RADIUS_RATIO" replaced.
+
+     Inputs: depth - Front-back visual depth of the ellipse's cell.
+
+    Outputs: The horizontal ("w") and vertical ("h") radii.
+*******************************************************************************/
+GSize get_float_ellipse_radii(const int8_t depth) {
+  uint8_t h_radius, v_radius;
+
+  h_radius = FLOAT_ELLIPSE_RADIUS_RATIO *
+               (g_back_wall_coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT].x -
+                g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].x);
+  if (depth == 0) {
+    v_radius = FLOAT_ELLIPSE_RADIUS_RATIO *
+                 g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y;
+  } else {
+    v_radius = FLOAT_ELLIPSE_RADIUS_RATIO *
+                 (g_back_wall_coords[depth][STRAIGHT_AHEAD][TOP_LEFT].y -
+                  g_back_wall_coords[depth - 1][STRAIGHT_AHEAD][TOP_LEFT].y);
+  }
+
+  return GSize(h_radius, v_radius);
+}
+
+/*******************************************************************************
+   Function: get_ellipse_half_width
+
+Description: Reference for "make check-projection": computes the largest
+             horizontal distance from an ellipse's center that's still inside
+             it on a given row, as "g_ellipse_half_widths" holds for the Q16
+             radii.
+
+     Inputs: h_radius - The ellipse's horizontal radius.
+             v_radius - The ellipse's vertical radius.
+             dy       - Rows above or below the center.
+
+    Outputs: The half-width of the row.
+*******************************************************************************/
+int16_t get_ellipse_half_width(const int16_t h_radius,
+                               const int16_t v_radius,
+                               const int16_t dy) {
+  int16_t x = h_radius;
+
+  while (x > 0 &&
+         (int32_t) x * x * v_radius * v_radius +
+           (int32_t) dy * dy * h_radius * h_radius >
+         (int32_t) h_radius * h_radius * v_radius * v_radius) {
+    x--;
+  }
+
+  return x;
+}
+
+/*******************************************************************************
+   Function: get_float_floor_center_point
+
+Description: Reference for "make check-projection": "get_floor_center_point"
+             as it was computed before the move to integer math.
+
+     Inputs: depth    - Front-back visual depth in "g_back_wall_coords".
+             position - Left-right visual position in "g_back_wall_coords".
+
+    Outputs: GPoint coordinates of the floor's central point within the
+             designated cell.
+*******************************************************************************/
+GPoint get_float_floor_center_point(const int8_t depth,
+                                    const int8_t position) {
+  int16_t x_midpoint1, x_midpoint2, x, y;
+
   x_midpoint1 = 0.5 * (g_back_wall_coords[depth][position][TOP_LEFT].x +
                        g_back_wall_coords[depth][position][BOTTOM_RIGHT].x);
   if (depth == 0) {
@@ -1715,6 +4684,7 @@ GPoint get_floor_center_point(const int8_t depth, const int8_t position) {
 
   return GPoint(x, y);
 }
+#endif
 
 /*******************************************************************************
    Function: get_ceiling_center_point
@@ -1825,7 +4795,81 @@ Description: Given a set of cell coordinates, returns the cell's type.
     Outputs: Integer representing the cell's type.
 *******************************************************************************/
 int8_t get_cell_type(GPoint cell_coords) {
-  return g_maze->cells[cell_coords.x][cell_coords.y];
+  if (g_endless.enabled) {
+    return get_endless_cell_type(cell_coords);
+  }
+
+  return MAZE_CELL_TYPE(g_maze, cell_coords);
+}
+
+/*******************************************************************************
+   Function: get_endless_cell_type
+
+Description: Given a set of cell coordinates in the endless labyrinth, returns
+             the cell's type (generating its chunk if need be).
+
+     Inputs: cell_coords - Coordinates of the cell of interest.
+
+    Outputs: Integer representing the cell's type.
+*******************************************************************************/
+int8_t get_endless_cell_type(const GPoint cell_coords) {
+  const chunk_t *const chunk = get_chunk(GPoint(cell_coords.x >> CHUNK_SHIFT,
+                                                cell_coords.y >> CHUNK_SHIFT));
+
+  return CHUNK_CELL_TYPE(chunk,
+                         cell_coords.x & (CHUNK_SIZE - 1),
+                         cell_coords.y & (CHUNK_SIZE - 1));
+}
+
+/*******************************************************************************
+   Function: set_maze_size
+
+Description: Sets a given maze's width and height and makes all of its cells
+             "solid", reallocating the cells if they need a different amount
+             of memory (so a maze only takes up as much as its size requires;
+             e.g., 60 bytes at 15x15).
+
+     Inputs: maze   - Pointer to the maze.
+             width  - The maze's new width (in cells).
+             height - The maze's new height (in cells).
+
+    Outputs: None.
+*******************************************************************************/
+void set_maze_size(maze_t *const maze,
+                   const int8_t width,
+                   const int8_t height) {
+  const uint16_t size = MAZE_ROW_BYTES(width) * height;
+
+  if (size != maze->cells_size) {
+    free(maze->cells);
+    maze->cells = malloc(size);
+    maze->cells_size = size;
+  }
+  memset(maze->cells, 0, size);  // "Solid" is cell type zero.
+  maze->row_bytes = MAZE_ROW_BYTES(width);
+  maze->width = width;
+  maze->height = height;
+}
+
+/*******************************************************************************
+   Function: set_cell_type
+
+Description: Sets the type of a given cell of a given maze. (Cells are packed
+             four to a byte; see "MAZE_CELL_TYPE".)
+
+     Inputs: maze        - Pointer to the maze.
+             cell_coords - Coordinates of the cell of interest.
+             type        - The cell's new type.
+
+    Outputs: None.
+*******************************************************************************/
+void set_cell_type(maze_t *const maze,
+                   const GPoint cell_coords,
+                   const int8_t type) {
+  uint8_t *const byte = &MAZE_CELL_BYTE(maze, cell_coords);
+
+  *byte = (*byte & ~(CELL_TYPE_MASK << CELL_SHIFT(cell_coords.x))) |
+            (type << CELL_SHIFT(cell_coords.x));
 }
 
 /*******************************************************************************
@@ -1839,10 +4883,15 @@ Description: Determines whether a given cell lies outside the current maze
     Outputs: Returns "true" if the cell is out of bounds.
 *******************************************************************************/
 bool out_of_bounds(const GPoint cell_coords) {
-  return cell_coords.x < 0 ||
-         cell_coords.x >= g_maze->width ||
-         cell_coords.y < 0 ||
-         cell_coords.y >= g_maze->height;
+  // (Negative coordinates become large unsigned values, failing the tests.)
+  if (g_endless.enabled) {
+    return (uint16_t) (cell_coords.x + ENDLESS_MAX_COORDINATE) >
+             2 * ENDLESS_MAX_COORDINATE ||
+           (uint16_t) (cell_coords.y + ENDLESS_MAX_COORDINATE) >
+             2 * ENDLESS_MAX_COORDINATE;
+  }
+  return (uint16_t) cell_coords.x >= (uint16_t) g_maze->width ||
+         (uint16_t) cell_coords.y >= (uint16_t) g_maze->height;
 }
 
 /*******************************************************************************
@@ -1850,14 +4899,37 @@ bool out_of_bounds(const GPoint cell_coords) {
 
 Description: Determines whether a given cell is "solid" (and is thus impassable
              and should have walls drawn around it). Out-of-bounds cells are
-             considered solid.
+             considered solid. (This is the renderer's innermost lookup, so
+             it's kept small enough to inline, leaving endless mode to
+             "is_endless_cell_solid".)
+
+     Inputs: cell_coords - Coordinates of the cell of interest.
+
+    Outputs: Returns "true" if the cell is solid.
+*******************************************************************************/
+inline bool is_solid(const GPoint cell_coords) {
+  if (g_endless.enabled) {
+    return is_endless_cell_solid(cell_coords);
+  }
+
+  return (uint16_t) cell_coords.x >= (uint16_t) g_maze->width ||
+         (uint16_t) cell_coords.y >= (uint16_t) g_maze->height ||
+         MAZE_CELL_IS_SOLID(g_maze, cell_coords);
+}
+
+/*******************************************************************************
+   Function: is_endless_cell_solid
+
+Description: Determines whether a given cell of the endless labyrinth is solid
+             (generating its chunk if need be).
 
      Inputs: cell_coords - Coordinates of the cell of interest.
 
     Outputs: Returns "true" if the cell is solid.
 *******************************************************************************/
-bool is_solid(const GPoint cell_coords) {
-  return out_of_bounds(cell_coords) || get_cell_type(cell_coords) == SOLID;
+bool is_endless_cell_solid(const GPoint cell_coords) {
+  return out_of_bounds(cell_coords) ||
+         get_endless_cell_type(cell_coords) == SOLID;
 }
 
 /*******************************************************************************
@@ -1945,6 +5017,7 @@ Description: Deinitializes the narration window.
 *******************************************************************************/
 void deinit_narration(void) {
   if (g_narration_window != NULL) {
+    status_bar_layer_destroy(g_narration_status_bar);
     text_layer_destroy(g_narration_text_layer);
     window_destroy(g_narration_window);
     g_narration_window = NULL;
@@ -1962,9 +5035,11 @@ Description: Initializes the MazeCrawler Pebble game.
 *******************************************************************************/
 void init(void) {
   int8_t i;
+  int32_t render_engine;
+  saved_maze_t saved_maze;
 
   g_game_paused = true;
-  srand(time(0));
+  init_random(&g_random, time(0));
 
   // Graphics window initialization:
   g_graphics_window = window_create();
@@ -1976,7 +5051,26 @@ void init(void) {
   window_set_click_config_provider(g_graphics_window,
                                    (ClickConfigProvider)
                                    graphics_click_config_provider);
-  layer_set_update_proc(window_get_root_layer(g_graphics_window), draw_scene);
+  g_scene_layer = layer_create(SCENE_LAYER_FRAME);
+  layer_set_update_proc(g_scene_layer, draw_scene);
+  layer_add_child(window_get_root_layer(g_graphics_window), g_scene_layer);
+  g_minimap_layer = layer_create(MINIMAP_LAYER_FRAME);
+  layer_set_update_proc(g_minimap_layer, draw_minimap);
+  layer_add_child(window_get_root_layer(g_graphics_window), g_minimap_layer);
+#ifdef PBL_COLOR
+  g_minimap_bitmap = gbitmap_create_blank(MINIMAP_LAYER_FRAME.size,
+                                          GBitmapFormat8Bit);
+#else
+  g_minimap_bitmap = gbitmap_create_blank(MINIMAP_LAYER_FRAME.size,
+                                          GBitmapFormat1Bit);
+#endif
+  g_lower_status_bar_layer = layer_create(LOWER_STATUS_BAR_FRAME);
+  layer_set_update_proc(g_lower_status_bar_layer, draw_lower_status_bar);
+  layer_add_child(window_get_root_layer(g_graphics_window),
+                  g_lower_status_bar_layer);
+  g_compass_layer = layer_create(COMPASS_LAYER_FRAME);
+  layer_set_update_proc(g_compass_layer, draw_compass);
+  layer_add_child(window_get_root_layer(g_graphics_window), g_compass_layer);
   g_level_text_layer = text_layer_create(LEVEL_TEXT_LAYER_FRAME);
   text_layer_set_background_color(g_level_text_layer, GColorClear);
   text_layer_set_text_color(g_level_text_layer, GColorWhite);
@@ -2139,26 +5233,63 @@ void init(void) {
 
   // Misc. variable initialization:
   g_narration_window = NULL;
+  g_backdrop = NULL;
+  g_wall_texture.data = NULL;
+  g_render_engine = DEFAULT_RENDER_ENGINE;
+  g_render_quality = FULL_QUALITY;
+  g_scene_dirty = true;
+  g_quality_timer = NULL;
+  g_maze_generation_timer = NULL;
+  g_save_timer = NULL;
+  g_maze_generator.maze = NULL;
+  g_last_frame_time = 0;
   g_new_best_time = -1;
   for (i = 0; i < NUM_ACHIEVEMENTS; ++i) {
     g_new_achievement_unlocked[i] = false;
   }
-  init_wall_coords();
+#ifdef PBL_BW
+  init_dither_masks();
+#endif
   g_compass_path = gpath_create(&COMPASS_PATH_INFO);
-  gpath_move_to(g_compass_path, GPoint(HALF_SCREEN_WIDTH,
-                                       GRAPHICS_FRAME_HEIGHT +
-                                         STATUS_BAR_HEIGHT +
-                                         STATUS_BAR_HEIGHT / 2));
+  gpath_move_to(g_compass_path, COMPASS_CENTER);
 
   // Load/init data and present main menu (after intro text, if applicable):
   window_stack_push(g_main_menu_window, ANIMATED);
   g_player = malloc(sizeof(player_t));
   g_maze = malloc(sizeof(maze_t));
+  g_next_maze = malloc(sizeof(maze_t));
+  g_maze->cells = g_next_maze->cells = NULL;  // See "set_maze_size".
+  g_maze->cells_size = g_next_maze->cells_size = 0;
+  if (persist_exists(OLD_MAZE_STORAGE_KEY)) {  // Replaced by a new maze below.
+    persist_delete(OLD_MAZE_STORAGE_KEY);
+  }
   if (persist_exists(PLAYER_STORAGE_KEY)) {
     persist_read_data(PLAYER_STORAGE_KEY, g_player, sizeof(player_t));
     if (persist_exists(MAZE_STORAGE_KEY)) {
-      persist_read_data(MAZE_STORAGE_KEY, g_maze, sizeof(maze_t));
+      persist_read_data(MAZE_STORAGE_KEY, &saved_maze, sizeof(saved_maze_t));
+      begin_maze_generation(saved_maze.seed);
+      finish_maze_generation();
+      g_maze->seconds = saved_maze.seconds;
       update_compass();
+      if (persist_read_chunks(MINIMAP_STORAGE_KEY,
+                              &g_minimap,
+                              sizeof(minimap_t))) {
+        redraw_minimap();
+      } else {
+        reset_minimap();
+      }
+      if (persist_exists(ENDLESS_STORAGE_KEY)) {
+        persist_read_data(ENDLESS_STORAGE_KEY, &g_endless, sizeof(endless_t));
+      }
+      if (persist_exists(RENDER_ENGINE_STORAGE_KEY)) {
+        render_engine = persist_read_int(RENDER_ENGINE_STORAGE_KEY);
+        if (RENDER_ENGINE_IS_BUILT(render_engine)) {  // Else the default.
+          g_render_engine = render_engine;
+        }
+      }
+      if (!g_endless.enabled) {
+        begin_maze_generation(get_new_maze_seed());  // For the next maze.
+      }
     } else {
       init_maze();
     }
@@ -2168,10 +5299,14 @@ void init(void) {
     g_current_narration = INTRO_NARRATION;
     show_narration();
   }
+  update_backdrop();
+  update_wall_texture();
+  layer_set_hidden(g_minimap_layer, !g_minimap.enabled || g_endless.enabled);
 
   // Subscribe to relevant services:
   app_focus_service_subscribe(app_focus_handler);
   tick_timer_service_subscribe(SECOND_UNIT, tick_handler);
+  log_heap_usage("init");
 }
 
 /*******************************************************************************
@@ -2184,13 +5319,20 @@ Description: Deinitializes the MazeCrawler Pebble game.
     Outputs: None.
 *******************************************************************************/
 void deinit(void) {
-  persist_write_data(PLAYER_STORAGE_KEY, g_player, sizeof(player_t));
-  persist_write_data(MAZE_STORAGE_KEY, g_maze, sizeof(maze_t));
+  if (g_save_timer != NULL) {
+    app_timer_cancel(g_save_timer);
+  }
+  save_game(NULL);
   app_focus_service_unsubscribe();
   tick_timer_service_unsubscribe();
+  if (g_quality_timer != NULL) {
+    app_timer_cancel(g_quality_timer);
+  }
+  if (g_maze_generation_timer != NULL) {
+    app_timer_cancel(g_maze_generation_timer);
+  }
   status_bar_layer_destroy(g_main_menu_status_bar);
   status_bar_layer_destroy(g_in_game_menu_status_bar);
-  status_bar_layer_destroy(g_narration_status_bar);
   status_bar_layer_destroy(g_graphics_status_bar);
   deinit_narration();
   menu_layer_destroy(g_main_menu);
@@ -2201,8 +5343,19 @@ void deinit(void) {
   window_destroy(g_message_box_window);
   text_layer_destroy(g_level_text_layer);
   text_layer_destroy(g_time_text_layer);
+  layer_destroy(g_compass_layer);
+  layer_destroy(g_lower_status_bar_layer);
+  layer_destroy(g_minimap_layer);
+  layer_destroy(g_scene_layer);
   window_destroy(g_graphics_window);
+  gbitmap_destroy(g_backdrop);
+  gbitmap_destroy(g_minimap_bitmap);
+  free(g_wall_texture.data);
+  clear_frame_cache();
+  free(g_maze->cells);
   free(g_maze);
+  free(g_next_maze->cells);
+  free(g_next_maze);
   free(g_player);
 }
 
@@ -61,6 +61,72 @@ enum {
   NUM_DIRECTIONS
 };
 
+// Maze generators (see "init_maze"):
+enum {
+  RECURSIVE_BACKTRACKER_GENERATOR,
+  WILSON_GENERATOR,
+  NUM_MAZE_GENERATORS
+};
+
+// Maze generation stages (see "generate_maze"):
+enum {
+  WILSON_WALK_STAGE,
+  WILSON_RETRACE_STAGE,
+  BACKTRACK_STAGE,
+  GENERATED_STAGE,
+  NUM_MAZE_GENERATION_STAGES
+};
+
+// Render engines:
+enum {
+  WALL_GRID_ENGINE,  // Walls drawn from "g_back_wall_coords" (see "draw_scene").
+  RAYCASTING_ENGINE,  // One ray per column (see "draw_raycast_scene").
+  NUM_RENDER_ENGINES
+};
+
+// Render quality levels (each also includes the savings of those above it):
+enum {
+  FULL_QUALITY,
+  FLAT_WALLS_QUALITY,  // Walls filled with a single color instead of shaded.
+  NEAR_WALLS_QUALITY,  // Only "REDUCED_VISIBILITY_DEPTH" depths drawn.
+  NO_CORNER_LINES_QUALITY,
+  NUM_RENDER_QUALITY_LEVELS
+};
+
+// Display list item types (in drawing order):
+enum {
+  BACK_WALL_ITEM,
+  LEFT_WALL_ITEM,
+  RIGHT_WALL_ITEM,
+  CORNER_LINE_ITEM,  // Black primitives from here on.
+  ENTRANCE_ITEM,
+  EXIT_ITEM,
+  NUM_DISPLAY_LIST_ITEM_TYPES
+};
+
+// Wall textures (see "tools/generate_wall_textures.py"):
+enum {
+  BRICK_TEXTURE,
+  STONE_TEXTURE,
+  NUM_WALL_TEXTURES
+};
+
+// Texel types (index values for a wall texture's palettes):
+enum {
+  MORTAR_TEXEL,
+  SHADOW_TEXEL,
+  FACE_TEXEL,
+  HIGHLIGHT_TEXEL,
+  NUM_TEXEL_TYPES
+};
+
+// Side walls (index values for "g_side_wall_columns"):
+enum {
+  LEFT_WALL,
+  RIGHT_WALL,
+  NUM_SIDE_WALLS
+};
+
 /*******************************************************************************
   Other Constants
 *******************************************************************************/
@@ -71,42 +137,84 @@ enum {
 #define ACHIEVEMENT_NAME_STR_LEN         15
 #define ACHIEVEMENT_DESC_STR_LEN         50
 #define NARRATION_STR_LEN                110
-#define SCREEN_WIDTH                     144
-#define SCREEN_HEIGHT                    168
+#define SCREEN_WIDTH                     PBL_DISPLAY_WIDTH  // Wall tables are generated to match (see the wscript).
+#define SCREEN_HEIGHT                    PBL_DISPLAY_HEIGHT
 #define HALF_SCREEN_WIDTH                (SCREEN_WIDTH / 2)
-#define STATUS_BAR_HEIGHT                16  // For top and bottom status bars.
-#define STATUS_BAR_PADDING               4
-#define FIRST_WALL_OFFSET                STATUS_BAR_HEIGHT
-#define MIN_WALL_HEIGHT                  STATUS_BAR_HEIGHT
+#define FIRST_WALL_OFFSET                16  // Inset of the nearest back wall from the graphics frame's edges.
+#define MIN_WALL_HEIGHT                  FIRST_WALL_OFFSET  // Shorter (i.e., farther) walls aren't drawn.
+#define LOW_DETAIL_DEPTH                 5  // Walls this deep or deeper are drawn flat, without corner lines.
+#define NUM_DETAILED_DEPTHS              (LOW_DETAIL_DEPTH < MAX_VISIBILITY_DEPTH - 1 ? LOW_DETAIL_DEPTH : MAX_VISIBILITY_DEPTH - 1)
+#define SHADING_ROWS_PER_STEP            6  // Wall top rows per step in "g_shading_offsets".
 #define GRAPHICS_FRAME_HEIGHT            (SCREEN_HEIGHT - 2 * STATUS_BAR_HEIGHT)
 #define GRAPHICS_FRAME_WIDTH             SCREEN_WIDTH
 #define FULL_SCREEN_FRAME                GRect(0, STATUS_BAR_HEIGHT, SCREEN_WIDTH, SCREEN_HEIGHT - STATUS_BAR_HEIGHT)
 #define GRAPHICS_FRAME                   GRect(0, STATUS_BAR_HEIGHT, SCREEN_WIDTH, GRAPHICS_FRAME_HEIGHT)
+#define BACKDROP_FRAME                   GRect(0, STATUS_BAR_HEIGHT, GRAPHICS_FRAME_WIDTH, GRAPHICS_FRAME_HEIGHT + 1)  // Incl. the floor's lowest row.
+#define COLUMN_COVERAGE_WORDS            ((GRAPHICS_FRAME_WIDTH + 31) / 32)  // One bit per column.
+#define COLUMN_IS_COVERED(x)             ((g_column_coverage[(x) / 32] >> ((x) % 32)) & 1)
+#define SCENE_LAYER_FRAME                GRect(0, 0, SCREEN_WIDTH, STATUS_BAR_HEIGHT + GRAPHICS_FRAME_HEIGHT + 1)
+#define LOWER_STATUS_BAR_FRAME           GRect(0, STATUS_BAR_HEIGHT + GRAPHICS_FRAME_HEIGHT + 1, SCREEN_WIDTH, STATUS_BAR_HEIGHT - 1)
+#define COMPASS_LAYER_FRAME              GRect(HALF_SCREEN_WIDTH - COMPASS_LAYER_SIZE / 2, GRAPHICS_FRAME_HEIGHT + STATUS_BAR_HEIGHT + STATUS_BAR_HEIGHT / 2 - COMPASS_LAYER_SIZE / 2, COMPASS_LAYER_SIZE, COMPASS_LAYER_SIZE)
 #define LEVEL_TEXT_LAYER_FRAME           GRect(STATUS_BAR_PADDING, STATUS_BAR_HEIGHT + GRAPHICS_FRAME_HEIGHT, HALF_SCREEN_WIDTH, STATUS_BAR_HEIGHT)
 #define TIME_TEXT_LAYER_FRAME            GRect(HALF_SCREEN_WIDTH, STATUS_BAR_HEIGHT + GRAPHICS_FRAME_HEIGHT, HALF_SCREEN_WIDTH - STATUS_BAR_PADDING, STATUS_BAR_HEIGHT)
-#define MESSAGE_BOX_FRAME                GRect(10, STATUS_BAR_HEIGHT + 15, SCREEN_WIDTH - 20, GRAPHICS_FRAME_HEIGHT - 30)
+#define MESSAGE_BOX_FRAME                GRect(MESSAGE_BOX_MARGIN, STATUS_BAR_HEIGHT + MESSAGE_BOX_MARGIN + 5, SCREEN_WIDTH - 2 * MESSAGE_BOX_MARGIN, GRAPHICS_FRAME_HEIGHT - 2 * (MESSAGE_BOX_MARGIN + 5))
 #define NARRATION_TEXT_LAYER_FRAME       GRect(2, STATUS_BAR_HEIGHT, SCREEN_WIDTH - 4, SCREEN_HEIGHT)
 #define STATUS_BAR_FONT                  fonts_get_system_font(FONT_KEY_GOTHIC_14)
 #define MESSAGE_BOX_FONT                 fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD)
 #define NARRATION_FONT                   fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD)
 #define NO_CORNER_RADIUS                 0
 #define COMPASS_RADIUS                   5
+#define COMPASS_LAYER_SIZE               (2 * COMPASS_RADIUS + 5)  // Leaves room for the needle's tip.
+#define COMPASS_CENTER                   GPoint(COMPASS_LAYER_SIZE / 2, COMPASS_LAYER_SIZE / 2)  // Within the compass layer.
 #define MIN_MAZE_WIDTH                   10  // Min. no. of cells per side.
 #define MIN_MAZE_HEIGHT                  MIN_MAZE_WIDTH
-#define MAX_MAZE_WIDTH                   15  // Max. no. of cells per side.
+#define MAX_MAZE_WIDTH                   64  // Max. no. of cells per side (see "get_max_maze_size").
 #define MAX_MAZE_HEIGHT                  MAX_MAZE_WIDTH
-#define MAX_VISIBILITY_DEPTH             6  // Helps determine no. of cells visible in a given line of sight.
+#define FIRST_MAX_MAZE_SIZE              15  // Max. no. of cells per side at level 1.
+#define LEVELS_PER_MAZE_SIZE_INCREASE    10  // Levels before mazes may grow by another cell per side.
+#define BITS_PER_CELL                    2  // Enough for the four cell types.
+#define CELLS_PER_BYTE                   (8 / BITS_PER_CELL)
+#define CELL_TYPE_MASK                   ((1 << BITS_PER_CELL) - 1)
+#define MAZE_ROW_BYTES(width)            (((width) + CELLS_PER_BYTE - 1) / CELLS_PER_BYTE)
+#define CELL_SHIFT(x)                    (((uint16_t) (x) % CELLS_PER_BYTE) * BITS_PER_CELL)  // Of a cell within its byte.
+#define MAZE_CELL_BYTE(maze, point)      ((maze)->cells[(uint16_t) (point).y * (maze)->row_bytes + (uint16_t) (point).x / CELLS_PER_BYTE])
+#define MAZE_CELL_TYPE(maze, point)      ((MAZE_CELL_BYTE(maze, point) >> CELL_SHIFT((point).x)) & CELL_TYPE_MASK)
 #define STRAIGHT_AHEAD                   (MAX_VISIBILITY_DEPTH - 1)  // Index value for "g_back_wall_coords".
 #define TOP_LEFT                         0  // Index value for "g_back_wall_coords".
 #define BOTTOM_RIGHT                     1  // Index value for "g_back_wall_coords".
-#define RANDOM_POINT_NORTH               GPoint(rand() % g_maze->width, rand() % (g_maze->height / 4))
-#define RANDOM_POINT_SOUTH               GPoint(rand() % g_maze->width, g_maze->height - (1 + rand() % (g_maze->height / 4)))
-#define RANDOM_POINT_EAST                GPoint(g_maze->width - (1 + rand() % (g_maze->width / 4)), rand() % g_maze->height)
-#define RANDOM_POINT_WEST                GPoint(rand() % (g_maze->width / 4), rand() % g_maze->height)
-#define NINETY_DEGREES                   (TRIG_MAX_ANGLE / 4)
-#define DEFAULT_ROTATION_RATE            (TRIG_MAX_ANGLE / 30)  // 12 degrees per rotation event
-#define ELLIPSE_RADIUS_RATIO             0.4
+#define ROTATE_LEFT(value, n)            (((value) << (n)) | ((value) >> (32 - (n))))  // Of a 32-bit value.
+#define MAZE_SEED_SIZE_SHIFT             24  // A maze seed's top byte is the maze's max. size (see "begin_maze_generation").
+#define MAZE_SEED(bits, max_size)        (((uint32_t) (bits) & ((1 << MAZE_SEED_SIZE_SHIFT) - 1)) | (uint32_t) (max_size) << MAZE_SEED_SIZE_SHIFT)
+#define MAZE_NODE(point)                 GPoint((point).x & ~1, (point).y & ~1)  // Nearest cell at even coordinates, up and to the left.
+#define MAX_MAZE_NODES                   (((MAX_MAZE_WIDTH + 1) / 2) * ((MAX_MAZE_HEIGHT + 1) / 2))
+#define MAZE_CELL_IS_SOLID(maze, point)  (MAZE_CELL_TYPE(maze, point) == SOLID)
+#define WALK_DIRECTION_INDEX(node)       (((uint16_t) (node).y / 2) * ((MAX_MAZE_WIDTH + 1) / 2) + (uint16_t) (node).x / 2)  // Into "g_walk_directions".
+#define WALK_DIRECTION(node)             ((g_walk_directions[WALK_DIRECTION_INDEX(node) / CELLS_PER_BYTE] >> CELL_SHIFT(WALK_DIRECTION_INDEX(node))) & CELL_TYPE_MASK)
+#ifndef WILSON_MAX_STEPS_PER_NODE  // (Lowered by a host test build; see "host/Makefile".)
+#define WILSON_MAX_STEPS_PER_NODE        32  // Random-walk budget (see "generate_maze").
+#endif
+#define MAZE_GENERATION_SLICE_STEPS      128  // Generation steps per timer callback.
+#define MAZE_GENERATION_SLICE_INTERVAL   20  // milliseconds between slices.
+#define MAZE_GENERATION_NO_STEP_LIMIT    INT32_MAX
+#define SAVE_DELAY                       1000  // milliseconds from a new maze to saving it.
+#define FIXED_POINT_SHIFT                16  // For Q16 fixed-point values.
+#define FIXED_POINT_ONE                  (1 << FIXED_POINT_SHIFT)
+#define ELLIPSE_RADIUS_RATIO             (FIXED_POINT_ONE * 2 / 5 + 1)  // 0.4, rounded up
+#ifdef FLOAT_PROJECTION
+#define FLOAT_ELLIPSE_RADIUS_RATIO       0.4  // What "ELLIPSE_RADIUS_RATIO" replaced (see "get_float_ellipse_radii").
+#endif
+#define DISPLAY_LIST_MAX_ITEMS           ((STRAIGHT_AHEAD * 2 + 1) * 6)  // Up to 3 walls, 2 corner lines and 1 marker per cell.
+#define DISPLAY_LIST_SORT_KEY(item)      ((item).type * (STRAIGHT_AHEAD * 2 + 2) + (item).position)  // Positions range from 0 to (STRAIGHT_AHEAD * 2) + 1.
+#define RAYCAST_FOCAL_LENGTH             (GRAPHICS_FRAME_WIDTH - 2 * FIRST_WALL_OFFSET)  // A wall one cell away is as wide as the first back wall.
+#define RAYCAST_MAX_DISTANCE             (MAX_VISIBILITY_DEPTH << FIXED_POINT_SHIFT)  // Q16, in cells.
+#define RAYCAST_REDUCED_DISTANCE         (REDUCED_VISIBILITY_DEPTH << FIXED_POINT_SHIFT)  // At "NEAR_WALLS_QUALITY" or lower.
+#define RAYCAST_MIN_RAY_COMPONENT        256  // Q16; smaller components are treated as nearly parallel to an axis.
+#define RAYCAST_TEXTURE_WIDTH            32  // Columns per cell of untextured walls' shading.
+#define RAYCAST_MARKER_RADIUS_SQUARED    ((ELLIPSE_RADIUS_RATIO >> 8) * (ELLIPSE_RADIUS_RATIO >> 8))  // Q16, in cells.
 #define CLICK_REPEAT_INTERVAL            300  // milliseconds
+#define FRAME_TIME_BUDGET                (CLICK_REPEAT_INTERVAL / 2)  // milliseconds; slower frames during rapid input lower the render quality.
+#define QUALITY_RESTORE_DELAY            (CLICK_REPEAT_INTERVAL * 2)  // milliseconds without a new frame before full quality returns.
+#define REDUCED_VISIBILITY_DEPTH         3  // No. of depths drawn at "NEAR_WALLS_QUALITY" or lower.
 #define MULTI_CLICK_MIN                  2
 #define MULTI_CLICK_MAX                  2  // We only care about double-clicks.
 #define MULTI_CLICK_TIMEOUT              0
@@ -119,15 +227,126 @@ enum {
 #define MAX_POINTS                       MAX_LARGE_INT_VALUE
 #define MAX_SECONDS                      3599  // 59:59 (just under an hour)
 #define MAIN_MENU_NUM_ROWS               4
-#define IN_GAME_MENU_NUM_ROWS            4
+#ifdef DRAW_STATS
+#define IN_GAME_MENU_NUM_ROWS            (7 + IN_GAME_MENU_ENGINE_ROWS)  // Incl. "Draw Stats" (see below).
+#else
+#define IN_GAME_MENU_NUM_ROWS            (6 + IN_GAME_MENU_ENGINE_ROWS)
+#endif
 #define INTRO_NARRATION_NUM_PAGES        4
 #define PLAYER_STORAGE_KEY               8417
-#define MAZE_STORAGE_KEY                 (PLAYER_STORAGE_KEY + 1)
+#define OLD_MAZE_STORAGE_KEY             (PLAYER_STORAGE_KEY + 1)  // 15x15 max., unpacked (no longer read).
+#define MINIMAP_STORAGE_KEY              (PLAYER_STORAGE_KEY + 2)
+#define NUM_STORAGE_CHUNKS(size)         (((size) + PERSIST_DATA_MAX_LENGTH - 1) / PERSIST_DATA_MAX_LENGTH)  // See "persist_write_chunks".
+#define MINIMAP_SIZE                     64  // Pixels per side (of the largest maze).
+#define MINIMAP_CELL_SIZE                (MINIMAP_SIZE / (g_maze->width > g_maze->height ? g_maze->width : g_maze->height))  // Pixels per side of a cell.
+#define MINIMAP_ROW_BYTES                (MAX_MAZE_WIDTH / 8)
+#define MINIMAP_MARGIN                   4  // Between the minimap and the top of the 3D view.
+#define MINIMAP_LAYER_FRAME              GRect(MINIMAP_LEFT, STATUS_BAR_HEIGHT + MINIMAP_MARGIN, MINIMAP_SIZE, MINIMAP_SIZE)
+#define MINIMAP_UNEXPLORED_COLOR         GColorBlack
+#define MINIMAP_IS_EXPLORED(x, y)        ((g_minimap.explored[y][(uint16_t) (x) / 8] >> ((uint16_t) (x) % 8)) & 1)
+#define MINIMAP_MIN_RING_SIZE            3  // Smaller player markers are drawn solid.
+#define ENDLESS_STORAGE_KEY              (MINIMAP_STORAGE_KEY + NUM_STORAGE_CHUNKS(sizeof(minimap_t)))
+#define MAZE_STORAGE_KEY                 (ENDLESS_STORAGE_KEY + 1)  // See "saved_maze_t".
+#define RENDER_ENGINE_STORAGE_KEY        (MAZE_STORAGE_KEY + 1)
+#define CHUNK_SHIFT                      4
+#define CHUNK_SIZE                       (1 << CHUNK_SHIFT)  // Cells per side of an endless-mode chunk (see "generate_chunk").
+#define CHUNK_ROW_BYTES                  (CHUNK_SIZE / CELLS_PER_BYTE)
+#define CHUNK_CELL_TYPE(chunk, x, y)     (((chunk)->cells[y][(x) / CELLS_PER_BYTE] >> CELL_SHIFT(x)) & CELL_TYPE_MASK)  // Given coordinates within the chunk.
+#define MAX_RESIDENT_CHUNKS              9  // Chunks kept in memory at once (enough for any view; see "get_chunk").
+#define CHUNK_EXTRA_OPENING_ODDS         6  // 1 in this many of a chunk's other border walls are opened too.
+#define ENDLESS_MAX_COORDINATE           (INT16_MAX / 2)  // Cells beyond this are solid, keeping coordinates clear of overflow.
+#define FRAME_CACHE_MAX_FRAMES           8
+#define FRAME_CACHE_HEAP_BUDGET          (FRAME_CACHE_BUDGET - FRAME_CACHE_SCRATCH_SIZE)  // For the compressed frames themselves.
+#define FRAME_CACHE_MAX_ROW_SIZE         (2 * FRAME_CACHE_ROW_BYTES + 1)  // Worst case: a header and one-byte literals.
+#define FRAME_CACHE_MAX_ROW_REFERENCE    12  // Max. no. of rows a cached row may refer back to.
+#define FRAME_CACHE_MAX_RUN              64  // Max. length of a single compressed run.
+#define FRAME_CACHE_OP_MASK              0xC0  // Top two bits of a compressed run's op byte.
+#define FRAME_CACHE_LITERAL              0x00
+#define FRAME_CACHE_ROW_COPY             0x80
+#define FRAME_CACHE_BACKDROP_COPY        0xC0
+#define DEFAULT_RENDER_ENGINE            WALL_GRID_ENGINE  // At least as fast as the raycaster on every platform (see "make bench-engines").
 #define ANIMATED                         true
 #define NOT_ANIMATED                     false
 #ifdef PBL_COLOR
 #define NUM_BACKGROUND_COLOR_SCHEMES     8
 #define NUM_BACKGROUND_COLORS_PER_SCHEME 10
+#define FRAME_CACHE_BUDGET               16384  // bytes, scratch included
+#define FRAME_CACHE_SCRATCH_SIZE         4096  // Larger frames aren't cached (see "cache_frame").
+#ifndef RAYCASTING_ENGINE_ENABLED
+#define RAYCASTING_ENGINE_ENABLED        // Selectable via the in-game menu.
+#endif
+#define WALL_TEXTURES_ENABLED            true
+#define MAX_VISIBILITY_DEPTH             12  // Helps determine no. of cells visible in a given line of sight.
+#define TEXTURE_SHADING_STEP             2  // Color index difference between faces and their highlights/shadows.
+#define FRAME_CACHE_ROW_BYTES            GRAPHICS_FRAME_WIDTH
+#define MINIMAP_FLOOR_COLOR              GColorLightGray
+#define MINIMAP_WALL_COLOR               GColorDarkGray
+#define MINIMAP_PLAYER_COLOR             GColorRed
+#else
+#define FRAME_CACHE_BUDGET               4096  // bytes, scratch included
+#define FRAME_CACHE_SCRATCH_SIZE         1536  // Most views compress to less than this.
+#define WALL_TEXTURES_ENABLED            false  // Dotted shading reads better in 1-bit.
+#define MAX_VISIBILITY_DEPTH             6  // Keeps the original stepped layout (see "tools/generate_wall_tables.py").
+#define FRAME_CACHE_ROW_BYTES            ((GRAPHICS_FRAME_WIDTH + 7) / 8)
+#define MAX_SHADING_OFFSET               (GRAPHICS_FRAME_HEIGHT / (2 * SHADING_ROWS_PER_STEP) + 2)
+#define EVEN_COLUMNS_MASK                0x55555555  // 1-bit frame buffer words.
+#define ODD_COLUMNS_MASK                 0xAAAAAAAA
+#define MINIMAP_FLOOR_COLOR              GColorWhite
+#define MINIMAP_WALL_COLOR               GColorBlack
+#define MINIMAP_PLAYER_COLOR             GColorBlack  // Drawn as a ring (see "draw_minimap").
+#endif
+#ifdef RAYCASTING_ENGINE_ENABLED  // (Decided per platform above.)
+#define IN_GAME_MENU_ENGINE_ROWS         1  // "Renderer".
+#define RENDER_ENGINE_IS_BUILT(engine)   ((engine) >= 0 && (engine) < NUM_RENDER_ENGINES)  // E.g., for a stored engine.
+#else
+#define IN_GAME_MENU_ENGINE_ROWS         0
+#define RENDER_ENGINE_IS_BUILT(engine)   ((engine) == WALL_GRID_ENGINE)
+#endif
+#ifdef PBL_ROUND
+#define STATUS_BAR_HEIGHT                24  // For top and bottom status bars (as "STATUS_BAR_LAYER_HEIGHT").
+#define STATUS_BAR_PADDING               44  // Keeps the lower status bar's text clear of the display's edge.
+#define MESSAGE_BOX_MARGIN               25
+#define MINIMAP_LEFT                     (HALF_SCREEN_WIDTH - MINIMAP_SIZE / 2)  // Centered, clear of the display's edge.
+#define FRAME_BUFFER_ROW(y)              g_frame_buffer_rows[y]  // Rows vary in length (see "set_frame_buffer").
+#define FRAME_BUFFER_ROW_LEFT(y)         g_frame_buffer_row_lefts[y]  // Leftmost visible column.
+#define FRAME_BUFFER_ROW_RIGHT(y)        g_frame_buffer_row_rights[y]  // Rightmost visible column.
+#define FRAME_BUFFER_COLUMN_TOP(x)       g_frame_buffer_column_tops[x]  // Topmost visible row.
+#define FRAME_BUFFER_COLUMN_BOTTOM(x)    g_frame_buffer_column_bottoms[x]  // Row just below the lowest visible one.
+#define FRAME_CACHE_ROW_START(y)         FRAME_BUFFER_ROW_LEFT(y)  // Only visible bytes are cached.
+#define FRAME_CACHE_ROW_END(y)           (FRAME_BUFFER_ROW_RIGHT(y) + 1)
+#else
+#define STATUS_BAR_HEIGHT                16  // For top and bottom status bars.
+#define STATUS_BAR_PADDING               4
+#define MESSAGE_BOX_MARGIN               10
+#define MINIMAP_LEFT                     (SCREEN_WIDTH - MINIMAP_SIZE - MINIMAP_MARGIN)
+#define FRAME_BUFFER_ROW(y)              (g_frame_buffer_data + (y) * g_frame_buffer_row_size)
+#define FRAME_BUFFER_ROW_LEFT(y)         0
+#define FRAME_BUFFER_ROW_RIGHT(y)        (SCREEN_WIDTH - 1)
+#define FRAME_BUFFER_COLUMN_TOP(x)       0
+#define FRAME_BUFFER_COLUMN_BOTTOM(x)    SCREEN_HEIGHT
+#define FRAME_CACHE_ROW_START(y)         0
+#define FRAME_CACHE_ROW_END(y)           FRAME_CACHE_ROW_BYTES
+#endif
+
+// Debug instrumentation: when "DRAW_STATS" is defined (e.g., via the wscript's
+// "--draw-stats" option), every drawing call made by "draw_scene" is counted,
+// and the totals for recent frames can be logged from the in-game menu:
+#ifdef DRAW_STATS
+#define DRAW_STATS_NUM_FRAMES            32  // Size of the "g_draw_stats" ring buffer.
+#define DRAW_STATS_ADD(field, n)         (g_draw_stats[g_draw_stats_index].field += (n))
+#define DRAW_STATS_BEGIN_FRAME()         begin_draw_stats_frame()
+#define DRAW_STATS_END_FRAME(time, cached) end_draw_stats_frame(time, cached)
+#define graphics_draw_pixel(ctx, point)  (DRAW_STATS_ADD(pixel_calls, 1), graphics_draw_pixel(ctx, point))
+#define graphics_draw_line(ctx, p0, p1)  (DRAW_STATS_ADD(line_calls, 1), graphics_draw_line(ctx, p0, p1))
+#define graphics_fill_rect(ctx, rect, radius, corners) (DRAW_STATS_ADD(rect_calls, 1), graphics_fill_rect(ctx, rect, radius, corners))
+#define graphics_fill_circle(ctx, center, radius) (DRAW_STATS_ADD(circle_calls, 1), graphics_fill_circle(ctx, center, radius))
+#define graphics_draw_bitmap_in_rect(ctx, bitmap, rect) (DRAW_STATS_ADD(bitmap_calls, 1), graphics_draw_bitmap_in_rect(ctx, bitmap, rect))
+#define graphics_context_set_stroke_color(ctx, color) (DRAW_STATS_ADD(stroke_color_calls, 1), graphics_context_set_stroke_color(ctx, color))
+#define graphics_context_set_fill_color(ctx, color) (DRAW_STATS_ADD(fill_color_calls, 1), graphics_context_set_fill_color(ctx, color))
+#else
+#define DRAW_STATS_ADD(field, n)         ((void) 0)
+#define DRAW_STATS_BEGIN_FRAME()         ((void) 0)
+#define DRAW_STATS_END_FRAME(time, cached) ((void) 0)
 #endif
 
 static const GPathInfo COMPASS_PATH_INFO = {
@@ -159,6 +378,11 @@ static const char *const g_narration_strings[3][4] = {
   },
 };
 
+static const uint32_t g_wall_texture_resource_ids[NUM_WALL_TEXTURES] = {
+  RESOURCE_ID_WALL_TEXTURE_BRICK,
+  RESOURCE_ID_WALL_TEXTURE_STONE,
+};
+
 static const char *const g_achievement_names[] = {
   "Addicted",
   "Speedy",
@@ -194,8 +418,10 @@ static const char *const g_achievement_descriptions[] = {
 *******************************************************************************/
 
 typedef struct Maze {
-  int8_t cells[MAX_MAZE_WIDTH][MAX_MAZE_HEIGHT],
-         width,
+  uint8_t *cells;  // Sized to fit the maze (see "set_maze_size").
+  uint16_t cells_size;  // bytes
+  uint8_t row_bytes;  // See "MAZE_CELL_TYPE".
+  int8_t width,
          height,
 #ifdef PBL_COLOR
          floor_color_scheme,
@@ -204,8 +430,15 @@ typedef struct Maze {
          starting_direction;
   int16_t seconds;
   GPoint entrance;
+  uint32_t seed;  // All of the above but "seconds" follows from this.
 } __attribute__((__packed__)) maze_t;
 
+// All that's stored of the current maze (which is regenerated from its seed):
+typedef struct SavedMaze {
+  uint32_t seed;
+  int16_t seconds;
+} __attribute__((__packed__)) saved_maze_t;
+
 typedef struct PlayerCharacter {
   GPoint position;
   int16_t direction,
@@ -215,6 +448,100 @@ typedef struct PlayerCharacter {
   bool achievement_unlocked[NUM_ACHIEVEMENTS];
 } __attribute__((__packed__)) player_t;
 
+// Cells the player has seen, for the minimap (stored with the maze):
+typedef struct Minimap {
+  uint8_t explored[MAX_MAZE_HEIGHT][MINIMAP_ROW_BYTES];  // See "MINIMAP_IS_EXPLORED".
+  bool enabled;  // Whether the minimap is shown over the 3D view.
+} __attribute__((__packed__)) minimap_t;
+
+// Endless mode's state (stored with the maze):
+typedef struct EndlessMode {
+  uint32_t seed;  // Every chunk is derived from this and its coordinates.
+  GPoint maze_position;  // Where the player left the current maze.
+  int8_t maze_direction;
+  bool enabled;  // If "true", "g_player" is in the endless labyrinth.
+} __attribute__((__packed__)) endless_t;
+
+// A piece of the endless labyrinth, generated when first seen:
+typedef struct Chunk {
+  uint8_t cells[CHUNK_SIZE][CHUNK_ROW_BYTES];  // See "CHUNK_CELL_TYPE".
+  GPoint coords;  // In chunks (i.e., cell coordinates >> "CHUNK_SHIFT").
+  uint32_t last_used;
+  bool loaded;
+} chunk_t;
+
+// State of a xoshiro128** pseudorandom number generator (see "get_random"):
+typedef struct Random {
+  uint32_t state[4];
+} random_t;
+
+// State of the next maze's generation, carried between time slices:
+typedef struct MazeGenerator {
+  maze_t *maze;  // Maze being generated, or NULL if none.
+  GPoint exit,
+         node,  // Start of Wilson's current walk, or the backtracker's root.
+         walker;  // Current node of Wilson's walk or retrace, or of the backtracker.
+  int32_t steps_left;  // Wilson's random-walk budget.
+  int8_t stage;
+  random_t random;  // Seeded with the maze's seed; makes every random choice.
+} maze_generator_t;
+
+typedef struct CachedFrame {
+  uint8_t *data;  // Compressed 3D view (see "cache_frame").
+  uint16_t size,
+           maze_id;
+  uint32_t last_used;
+  GPoint position;
+  int8_t direction;
+} cached_frame_t;
+
+typedef struct DisplayListItem {
+  int8_t type,
+         position;  // Left-right visual position in "g_back_wall_coords".
+} display_list_item_t;
+
+typedef struct WallTexture {
+  uint8_t *data;  // Raw resource (see "tools/generate_wall_textures.py").
+  uint8_t *mips[NUM_DETAILED_DEPTHS];  // One per depth, within "data".
+  uint8_t tile_widths[NUM_DETAILED_DEPTHS],
+          tile_heights[NUM_DETAILED_DEPTHS];
+  GColor palettes[NUM_DETAILED_DEPTHS][NUM_TEXEL_TYPES];
+  int8_t texture;  // Which of the wall textures has been loaded.
+#ifdef PBL_COLOR
+  int8_t color_scheme;  // Wall color scheme the palettes were built from.
+#endif
+} wall_texture_t;
+
+#ifdef DRAW_STATS
+// Drawing done by a single call to "draw_scene":
+typedef struct DrawStats {
+  uint16_t pixel_calls,  // Calls to each drawing function.
+           line_calls,
+           rect_calls,
+           circle_calls,
+           bitmap_calls,
+           stroke_color_calls,
+           fill_color_calls,
+           frame_time;  // In milliseconds (see "get_time_in_ms").
+  uint32_t direct_pixels;  // Written straight into the captured frame buffer.
+  bool cached;  // Whether the frame was restored from the frame cache.
+} draw_stats_t;
+#endif
+
+typedef struct WallColumns {
+  int16_t first_column;  // Leftmost on-screen column.
+  uint8_t num_columns;
+  uint16_t first_rise_index;  // Into "g_side_wall_rises", etc.
+} wall_columns_t;
+
+/*******************************************************************************
+  Precomputed Tables
+*******************************************************************************/
+
+// Wall geometry and shading, generated at build time for the target platform's
+// screen (see "tools/generate_wall_tables.py"):
+#include "wall_tables.h"
+
 /*******************************************************************************
   Global Variables
 *******************************************************************************/
@@ -227,6 +554,10 @@ Window *g_main_menu_window,
 MenuLayer *g_main_menu,
           *g_in_game_menu;
 ScrollLayer *g_scroll_layer;
+Layer *g_scene_layer,  // The 3D view.
+      *g_minimap_layer,
+      *g_lower_status_bar_layer,
+      *g_compass_layer;
 TextLayer *g_level_text_layer,
           *g_time_text_layer,
           *g_message_box_text_layer,
@@ -237,20 +568,70 @@ StatusBarLayer *g_main_menu_status_bar,
                *g_graphics_status_bar;
 char g_message_str[MESSAGE_STR_LEN + 1],
      g_narration_str[NARRATION_STR_LEN + 1];
-maze_t *g_maze;
+maze_t *g_maze,
+       *g_next_maze;  // Generated in the background (see "init_maze").
+maze_generator_t g_maze_generator;
+random_t g_random;  // For everything but generation (e.g., new seeds).
+minimap_t g_minimap;
+endless_t g_endless;
+chunk_t g_chunks[MAX_RESIDENT_CHUNKS],
+        *g_last_chunk;  // The most recently used chunk, if any.
+uint8_t g_walk_directions[(MAX_MAZE_NODES + CELLS_PER_BYTE - 1) / CELLS_PER_BYTE];  // See "WALK_DIRECTION".
+GBitmap *g_minimap_bitmap;  // Updated a cell at a time (see "reveal_minimap_cells").
 player_t *g_player;
-GPoint g_back_wall_coords[MAX_VISIBILITY_DEPTH - 1]
-                         [(STRAIGHT_AHEAD * 2) + 1]
-                         [2];
 int8_t g_current_narration,
-       g_narration_page_num;
+       g_narration_page_num,
+       g_render_engine,  // Clear the frame cache whenever this changes.
+       g_render_quality;  // Only full-quality frames are cached.
 int16_t g_new_best_time;
 bool g_game_paused,
+     g_scene_dirty,  // Whether the 3D view has changed since last drawn.
      g_new_achievement_unlocked[NUM_ACHIEVEMENTS];
 GPath *g_compass_path;
+GBitmap *g_frame_buffer,  // Non-NULL only while being drawn into directly.
+        *g_backdrop;  // Cached floor and ceiling (see "update_backdrop").
+wall_texture_t g_wall_texture;  // "data" is NULL if walls aren't textured.
+uint8_t *g_frame_buffer_data;
+uint16_t g_frame_buffer_row_size;
+#ifdef PBL_ROUND
+GBitmap *g_frame_buffer_layout;  // Bitmap described by the following tables.
+uint8_t *g_frame_buffer_rows[SCREEN_HEIGHT + 1];  // Column zero of each row (and a spare).
+int16_t g_frame_buffer_row_lefts[SCREEN_HEIGHT],
+        g_frame_buffer_row_rights[SCREEN_HEIGHT],
+        g_frame_buffer_column_tops[SCREEN_WIDTH],
+        g_frame_buffer_column_bottoms[SCREEN_WIDTH];
+#endif
+uint32_t g_column_coverage[COLUMN_COVERAGE_WORDS],  // Columns hidden by walls.
+         g_new_column_coverage[COLUMN_COVERAGE_WORDS];  // Current depth's.
+cached_frame_t g_frame_cache[FRAME_CACHE_MAX_FRAMES],
+               g_uncached_frame,  // Shown frame if not worth caching.
+               *g_shown_frame;  // Last view drawn or restored, or "NULL".
+uint8_t g_frame_cache_scratch[FRAME_CACHE_SCRATCH_SIZE];  // Where frames are compressed.
+display_list_item_t g_display_list[DISPLAY_LIST_MAX_ITEMS];  // Current depth's.
+uint8_t g_display_list_size;
+uint16_t g_frame_cache_size,  // Bytes of compressed frames in "g_frame_cache".
+         g_maze_id;  // Incremented whenever a new maze is generated.
+uint32_t g_frame_cache_clock,
+         g_chunk_clock,
+         g_last_frame_time;  // Last frame rendered (not restored), in ms.
+AppTimer *g_quality_timer,  // Non-NULL while waiting to restore full quality.
+         *g_maze_generation_timer,  // Non-NULL while the next maze is generated.
+         *g_save_timer;  // Non-NULL while a save is pending.
+int16_t g_covered_tops[GRAPHICS_FRAME_WIDTH],  // Covered span of each column.
+        g_covered_bottoms[GRAPHICS_FRAME_WIDTH],
+        g_new_covered_tops[GRAPHICS_FRAME_WIDTH],
+        g_new_covered_bottoms[GRAPHICS_FRAME_WIDTH];
 #ifdef PBL_COLOR
 GColor g_background_colors[NUM_BACKGROUND_COLOR_SCHEMES]
                           [NUM_BACKGROUND_COLORS_PER_SCHEME];
+int8_t g_backdrop_color_scheme;
+#else
+uint32_t g_dither_masks[MAX_SHADING_OFFSET + 1];
+#endif
+#ifdef DRAW_STATS
+draw_stats_t g_draw_stats[DRAW_STATS_NUM_FRAMES];  // Ring buffer of recent frames.
+uint8_t g_draw_stats_index,  // Frame currently being counted.
+        g_draw_stats_num_frames;  // Frames recorded so far (up to the max.).
 #endif
 
 /*******************************************************************************
@@ -264,29 +645,146 @@ void reposition_player(void);
 bool move_player(const int8_t direction);
 bool shift_position(GPoint *const position, const int8_t direction);
 bool check_for_maze_completion(void);
-void init_wall_coords(void);
 void init_maze(void);
+void log_heap_usage(const char *const event);
+void begin_maze_generation(const uint32_t seed);
+void finish_maze_generation(void);
+uint32_t get_new_maze_seed(void);
+GPoint get_random_edge_point(const maze_t *const maze,
+                             const int8_t side,
+                             random_t *const random);
+void cancel_maze_generation(void);
+void continue_maze_generation(void *data);
+bool generate_maze(const int32_t max_steps);
+int8_t get_node_directions(const maze_t *const maze,
+                           const GPoint node,
+                           const bool unvisited_only,
+                           int8_t directions[NUM_DIRECTIONS]);
+void carve_passage(maze_t *const maze,
+                   const GPoint node,
+                   const int8_t direction);
+void save_game(void *data);
 int8_t set_maze_starting_direction(void);
+bool advance_maze_generator_node(void);
+void set_walk_direction(const GPoint node, const int8_t direction);
+void persist_write_chunks(const uint32_t first_key,
+                          const void *const data,
+                          const size_t size);
+bool persist_read_chunks(const uint32_t first_key,
+                         void *const data,
+                         const size_t size);
+int8_t get_max_maze_size(void);
+void set_endless_mode(const bool enabled);
+void reset_endless_world(void);
+void clear_chunks(void);
+chunk_t *get_chunk(const GPoint coords);
+void generate_chunk(chunk_t *const chunk, const GPoint coords);
+uint32_t get_chunk_seed(const GPoint coords);
+void init_random(random_t *const random, uint32_t seed);
+uint32_t get_random(random_t *const random);
+uint32_t mix_bits(uint32_t value);
 void draw_scene(Layer *layer, GContext *ctx);
-void draw_floor_and_ceiling(GContext *ctx);
-bool draw_cell_contents(GContext *ctx,
-                        const GPoint cell_coords,
-                        const int8_t depth,
-                        const int8_t position);
+void update_render_quality(const bool rapid_input, const uint32_t frame_time);
+void restore_render_quality(void *data);
+uint32_t get_time_in_ms(void);
+#ifdef DRAW_STATS
+void begin_draw_stats_frame(void);
+void end_draw_stats_frame(const uint32_t frame_time, const bool cached);
+void log_draw_stats(void);
+#endif
+bool draw_cells_at_depth(GContext *ctx, const int8_t depth);
+bool build_display_list(const int8_t depth);
+bool add_display_list_item(const int8_t type, const int8_t position);
+void rasterize_display_list(GContext *ctx, const int8_t depth);
+#ifdef RAYCASTING_ENGINE_ENABLED
+void draw_raycast_scene(GContext *ctx, const int32_t angle);
+void draw_raycast_markers(GContext *ctx,
+                          const int16_t x,
+                          const int16_t first_row,
+                          const int32_t max_distance,
+                          const int32_t ray_x,
+                          const int32_t ray_y);
+int32_t get_direction_angle(const int8_t direction);
+#endif
+void mark_column_covered(const int16_t x,
+                         const int16_t top,
+                         const int16_t bottom);
+bool columns_are_covered(int16_t left, int16_t right);
+bool update_column_coverage(void);
+void cache_frame(void);
+int8_t find_frame_row_reference(const int16_t y);
+uint16_t compress_frame_row(const int16_t y,
+                            const int8_t reference,
+                            uint8_t *const data);
+cached_frame_t *find_cached_frame(void);
+bool restore_cached_frame(Layer *layer,
+                          GContext *ctx,
+                          cached_frame_t *const frame);
+void clear_frame_cache(void);
+void draw_floor_and_ceiling(GContext *ctx, const int16_t top);
+void update_backdrop(void);
+void update_wall_texture(void);
 bool draw_wall(GContext *ctx,
                const GPoint upper_left,
                const GPoint lower_left,
                const GPoint upper_right,
-               const GPoint lower_right);
+               const GPoint lower_right,
+               const int8_t depth,
+               const wall_columns_t *const columns);
+void draw_textured_wall_column(GContext *ctx,
+                               const int16_t x,
+                               int16_t top,
+                               int16_t bottom,
+                               const int8_t depth,
+                               const int16_t texture_column);
+void draw_wall_column(GContext *ctx,
+                      const int16_t x,
+                      int16_t top,
+                      int16_t bottom,
+                      const int16_t shading_offset,
+                      const int16_t phase,
+                      const GColor color);
+void draw_line_segment(GContext *ctx,
+                       const GPoint start,
+                       const GPoint end,
+                       const GColor color);
+#ifdef PBL_BW
+void draw_wall_rows(int16_t left,
+                    int16_t right,
+                    int16_t top,
+                    int16_t bottom,
+                    const bool flat);
+void draw_dotted_row(const int16_t y,
+                     const int16_t first_x,
+                     const int16_t spacing);
+void write_frame_buffer_row(const int16_t y,
+                            const int16_t left,
+                            const int16_t right,
+                            const uint32_t pattern);
+void init_dither_masks(void);
+#endif
+void draw_frame_buffer_pixel(const int16_t x,
+                             const int16_t y,
+                             const GColor color);
+bool capture_frame_buffer(GContext *ctx);
+void set_frame_buffer(GBitmap *const bitmap);
+void release_frame_buffer(GContext *ctx);
 bool draw_entrance(GContext *ctx, const int8_t depth, const int8_t position);
 bool draw_exit(GContext *ctx, const int8_t depth, const int8_t position);
 bool fill_ellipse(GContext *ctx,
                   const GPoint center,
-                  const uint8_t h_radius,
-                  const uint8_t v_radius,
+                  const int8_t depth,
                   const GColor color);
-void update_status_bar(GContext *ctx);
+void update_level_text(void);
+void update_time_text(void);
+void draw_lower_status_bar(Layer *layer, GContext *ctx);
+void draw_compass(Layer *layer, GContext *ctx);
 void update_compass(void);
+void reset_minimap(void);
+void redraw_minimap(void);
+void reveal_minimap_cells(const GPoint position);
+void draw_minimap_cell(const GPoint cell);
+void draw_minimap(Layer *layer, GContext *ctx);
 void show_message_box(void);
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed);
 void app_focus_handler(const bool in_focus);
@@ -326,6 +824,21 @@ void in_game_menu_select_callback(MenuLayer *menu_layer,
 int8_t get_num_achievements_unlocked(void);
 int8_t get_new_achievement_index(void);
 GPoint get_floor_center_point(const int8_t depth, const int8_t position);
+#ifdef FLOAT_PROJECTION
+void get_float_wall_edges(const GPoint upper_left,
+                          const GPoint lower_left,
+                          const GPoint upper_right,
+                          const int16_t column,
+                          int16_t *const top,
+                          int16_t *const bottom,
+                          int16_t *const truncated_rise);
+GSize get_float_ellipse_radii(const int8_t depth);
+int16_t get_ellipse_half_width(const int16_t h_radius,
+                               const int16_t v_radius,
+                               const int16_t dy);
+GPoint get_float_floor_center_point(const int8_t depth,
+                                    const int8_t position);
+#endif
 GPoint get_ceiling_center_point(const int8_t depth, const int8_t position);
 GPoint get_cell_farther_away(const GPoint reference_point,
                              const int8_t direction,
@@ -337,8 +850,18 @@ GPoint get_cell_to_the_right(const GPoint reference_point,
                              const int8_t reference_direction,
                              const int8_t distance);
 int8_t get_cell_type(GPoint cell_coords);
+int8_t get_endless_cell_type(const GPoint cell_coords)
+  __attribute__((__noinline__));  // (See "is_solid".)
+void set_maze_size(maze_t *const maze,
+                   const int8_t width,
+                   const int8_t height);
+void set_cell_type(maze_t *const maze,
+                   const GPoint cell_coords,
+                   const int8_t type);
 bool out_of_bounds(const GPoint cell_coords);
 bool is_solid(const GPoint cell_coords);
+bool is_endless_cell_solid(const GPoint cell_coords)
+  __attribute__((__noinline__));
 int8_t get_opposite_direction(const int8_t direction);
 void strcat_time(char *const dest_str, int16_t seconds);
 void init_narration(void);
@@ -0,0 +1,419 @@
+#!/usr/bin/env python
+"""
+   Filename: generate_wall_tables.py
+
+Description: Build-time generator for "wall_tables.h", which holds MazeCrawler's
+             wall geometry and shading tables as "static const" data so the app
+             needn't compute them at runtime. The wscript runs this once per
+             target platform:
+
+                 generate_wall_tables.py <screen width> <screen height> \\
+                                         <status bar height> \\
+                                         <max. visibility depth>
+
+             (The header is written to standard output.)
+"""
+
+from __future__ import division
+
+import sys
+
+# These must match "src/maze_crawler.h" (the generated header checks them):
+FIRST_WALL_OFFSET = 16
+MIN_WALL_HEIGHT = FIRST_WALL_OFFSET
+MAX_STEPPED_VISIBILITY_DEPTH = 6  # Deeper views use true perspective.
+LOW_DETAIL_DEPTH = 5
+SHADING_ROWS_PER_STEP = 6
+NUM_BACKGROUND_COLORS_PER_SCHEME = 10
+PERSPECTIVE_MODIFIER = 2  # Helps determine FOV, etc.
+FIXED_POINT_SHIFT = 16
+ELLIPSE_RADIUS_RATIO = (1 << FIXED_POINT_SHIFT) * 2 // 5 + 1  # 0.4, rounded up
+
+TOP_LEFT, BOTTOM_RIGHT = 0, 1
+LEFT_WALL, RIGHT_WALL = 0, 1
+
+# Set per platform by "set_status_bar_height" and "set_visibility_depth":
+STATUS_BAR_HEIGHT = 16
+MAX_VISIBILITY_DEPTH = MAX_STEPPED_VISIBILITY_DEPTH
+STRAIGHT_AHEAD = MAX_VISIBILITY_DEPTH - 1
+
+
+def set_status_bar_height(height):
+    """Sets the height of the status bars above and below the 3D view (taller
+    on round displays)."""
+    global STATUS_BAR_HEIGHT
+    STATUS_BAR_HEIGHT = height
+
+
+def get_graphics_frame_height(screen_height):
+    """Returns the height of the 3D view, between the status bars."""
+    return screen_height - 2 * STATUS_BAR_HEIGHT
+
+
+def set_visibility_depth(depth):
+    """Sets the max. visibility depth (and hence the no. of positions on either
+    side of straight ahead) that the other functions work with."""
+    global MAX_VISIBILITY_DEPTH, STRAIGHT_AHEAD
+    MAX_VISIBILITY_DEPTH = depth
+    STRAIGHT_AHEAD = depth - 1
+
+
+def get_num_detailed_depths():
+    """Returns the no. of depths drawn with full detail (shading, textures and
+    corner lines)."""
+    return min(LOW_DETAIL_DEPTH, MAX_VISIBILITY_DEPTH - 1)
+
+
+def get_back_wall_coords(width, height):
+    """Returns the top-left and bottom-right points of every potential back
+    wall, indexed by depth and then by left-right position.
+
+    Views up to "MAX_STEPPED_VISIBILITY_DEPTH" deep keep the original layout,
+    in which each depth's walls are inset from the last by a steadily
+    shrinking step. The steps run out after a handful of depths, so deeper
+    views scale the nearest wall by true perspective instead, with the eye
+    placed so that the farthest depth's walls are "MIN_WALL_HEIGHT" tall."""
+    coords = [[[(0, 0), (0, 0)] for j in range(STRAIGHT_AHEAD * 2 + 1)]
+              for i in range(MAX_VISIBILITY_DEPTH - 1)]
+    near_width = width - 2 * FIRST_WALL_OFFSET
+    near_height = height - 2 * FIRST_WALL_OFFSET
+    eye_distance = (MIN_WALL_HEIGHT * (MAX_VISIBILITY_DEPTH - 2) /
+                    (near_height - MIN_WALL_HEIGHT))
+    for i in range(MAX_VISIBILITY_DEPTH - 1):
+        if MAX_VISIBILITY_DEPTH <= MAX_STEPPED_VISIBILITY_DEPTH:
+            x = y = FIRST_WALL_OFFSET - i * PERSPECTIVE_MODIFIER
+            if i > 0:
+                x += coords[i - 1][STRAIGHT_AHEAD][TOP_LEFT][0]
+                y += coords[i - 1][STRAIGHT_AHEAD][TOP_LEFT][1]
+        else:  # Dimensions are kept even, so walls stay centered.
+            scale = eye_distance / (eye_distance + i)
+            x = (width - 2 * int(round(near_width * scale / 2))) // 2
+            y = (height - 2 * int(round(near_height * scale / 2))) // 2
+        wall_width = width - 2 * x
+        for j in range(-STRAIGHT_AHEAD, STRAIGHT_AHEAD + 1):
+            coords[i][STRAIGHT_AHEAD + j] = [(x + wall_width * j, y),
+                                             (width - x + wall_width * j,
+                                              height - y)]
+
+    return coords
+
+
+def get_shading_offset(y):
+    """Returns the distance between colored points for a wall column whose
+    top is at "y" (or for the floor and ceiling rows "y" pixels from the
+    edges of the graphics frame)."""
+    shading_offset = 1 + y // SHADING_ROWS_PER_STEP
+    if y % SHADING_ROWS_PER_STEP >= (SHADING_ROWS_PER_STEP // 2 +
+                                     SHADING_ROWS_PER_STEP % 2):
+        shading_offset += 1
+
+    return shading_offset
+
+
+def get_side_wall(coords, width, side, depth, position):
+    """Returns the upper-left and upper-right points of a side wall, exactly
+    as "draw_cell_contents" positions it."""
+    top = coords[depth][position][TOP_LEFT][1]
+    if depth == 0:
+        y_offset = top
+    else:
+        y_offset = top - coords[depth - 1][position][TOP_LEFT][1]
+    if side == LEFT_WALL:
+        right = coords[depth][position][TOP_LEFT][0]
+        left = 0 if depth == 0 else coords[depth - 1][position][TOP_LEFT][0]
+        return (left, top - y_offset), (right, top)
+    left = coords[depth][position][BOTTOM_RIGHT][0]
+    if depth == 0:
+        right = width - 1
+    else:
+        right = coords[depth - 1][position][BOTTOM_RIGHT][0]
+    return (left, top), (right, top - y_offset)
+
+
+def get_visible_half_width(coords, width, depth):
+    """Returns how many positions on either side of straight ahead can appear
+    on-screen at a given depth, judging each cell by the columns spanned by its
+    near and far sides (and skipping cells too short to be drawn)."""
+    half_width = 0
+    for position in range(STRAIGHT_AHEAD * 2 + 1):
+        top_left, bottom_right = coords[depth][position]
+        if bottom_right[1] - top_left[1] < MIN_WALL_HEIGHT:
+            continue
+        if depth == 0:
+            left = (position - STRAIGHT_AHEAD) * width
+            right = left + width - 1
+        else:
+            left = coords[depth - 1][position][TOP_LEFT][0]
+            right = coords[depth - 1][position][BOTTOM_RIGHT][0]
+        left = min(left, top_left[0])
+        right = max(right, bottom_right[0])
+        if right >= 0 and left < width:
+            half_width = max(half_width, abs(position - STRAIGHT_AHEAD))
+
+    return half_width
+
+
+def get_rises(upper_left, upper_right, column):
+    """Returns how far a side wall's top edge has risen (or fallen) at a given
+    column, rounded down and rounded toward zero."""
+    dx = upper_right[0] - upper_left[0]
+    dy = upper_right[1] - upper_left[1]
+    k = column - upper_left[0]
+    if dx <= 0:
+        return 0, 0
+    rise = (k * dy) // dx
+    truncated_rise = rise if dy >= 0 else -((k * -dy) // dx)
+
+    return rise, truncated_rise
+
+
+def get_exact_top(upper_left, upper_right, column):
+    """Returns the unrounded height of a side wall's top edge at a given
+    column."""
+    dx = upper_right[0] - upper_left[0]
+    if dx <= 0:
+        return upper_left[1]
+
+    return upper_left[1] + float(column - upper_left[0]) * (
+        upper_right[1] - upper_left[1]) / dx
+
+
+def get_texture_column(coords, frame_height, depth, top):
+    """Returns which column of a cell's worth of texels (at the scale of the
+    back wall at a given depth) lies at a side wall column whose top is at
+    "top", counting from the wall's near edge. Heights are interpolated as
+    reciprocals, so the texture is foreshortened along with the wall."""
+    near_height = frame_height if depth == 0 else (
+        coords[depth - 1][STRAIGHT_AHEAD][BOTTOM_RIGHT][1] -
+        coords[depth - 1][STRAIGHT_AHEAD][TOP_LEFT][1])
+    far_height = (coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT][1] -
+                  coords[depth][STRAIGHT_AHEAD][TOP_LEFT][1])
+    cell_width = (coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT][0] -
+                  coords[depth][STRAIGHT_AHEAD][TOP_LEFT][0])
+    height = max(frame_height - 2 * top, far_height)
+    t = (float(near_height - height) * far_height /
+         ((near_height - far_height) * height))
+
+    return min(max(int(t * cell_width), 0), cell_width - 1)
+
+
+def get_ellipse_radii(coords, depth):
+    """Returns the horizontal and vertical radii of the entrance and exit
+    markers at a given depth. (Every position at a given depth shares the same
+    radii, and the floor mirrors the ceiling.)"""
+    top_left = coords[depth][STRAIGHT_AHEAD][TOP_LEFT]
+    bottom_right = coords[depth][STRAIGHT_AHEAD][BOTTOM_RIGHT]
+    h_radius = (ELLIPSE_RADIUS_RATIO *
+                (bottom_right[0] - top_left[0])) >> FIXED_POINT_SHIFT
+    if depth == 0:
+        v_radius = (ELLIPSE_RADIUS_RATIO * top_left[1]) >> FIXED_POINT_SHIFT
+    else:
+        v_radius = (ELLIPSE_RADIUS_RATIO *
+                    (top_left[1] - coords[depth - 1][STRAIGHT_AHEAD][TOP_LEFT][1])
+                    ) >> FIXED_POINT_SHIFT
+
+    return h_radius, v_radius
+
+
+def get_ellipse_half_width(h_radius, v_radius, dy):
+    """Returns the largest horizontal distance from an ellipse's center
+    that's still inside it on the row "dy" rows above or below the center.
+    (Only rows strictly inside the vertical radius are drawn, so there are no
+    single-pixel tips.)"""
+    x = h_radius
+    while x > 0 and (x * x * v_radius * v_radius + dy * dy * h_radius *
+                     h_radius > h_radius * h_radius * v_radius * v_radius):
+        x -= 1
+
+    return x
+
+
+def format_values(values, indent='  ', per_line=12):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ', '.join('%d' % v
+                                        for v in values[i:i + per_line]))
+
+    return ',\n'.join(lines)
+
+
+def main():
+    width, height = int(sys.argv[1]), int(sys.argv[2])
+    set_status_bar_height(int(sys.argv[3]))
+    set_visibility_depth(int(sys.argv[4]))
+    graphics_frame_height = get_graphics_frame_height(height)
+    coords = get_back_wall_coords(width, graphics_frame_height)
+    focal_length = width - 2 * FIRST_WALL_OFFSET  # Raycaster pixels per cell.
+    out = []
+
+    out.append('/* Generated by tools/generate_wall_tables.py for a %dx%d '
+               'screen and a view\n   %d cells deep. Do not edit. */' %
+               (width, height, MAX_VISIBILITY_DEPTH))
+    out.append('#ifndef WALL_TABLES_H_')
+    out.append('#define WALL_TABLES_H_')
+    out.append('')
+    out.append('#if SCREEN_WIDTH != %d || SCREEN_HEIGHT != %d || \\' %
+               (width, height))
+    out.append('    STATUS_BAR_HEIGHT != %d || FIRST_WALL_OFFSET != %d || \\' %
+               (STATUS_BAR_HEIGHT, FIRST_WALL_OFFSET))
+    out.append('    MAX_VISIBILITY_DEPTH != %d || LOW_DETAIL_DEPTH != %d || '
+               '\\' % (MAX_VISIBILITY_DEPTH, LOW_DETAIL_DEPTH))
+    out.append('    MIN_WALL_HEIGHT != %d || SHADING_ROWS_PER_STEP != %d || '
+               '\\' % (MIN_WALL_HEIGHT, SHADING_ROWS_PER_STEP))
+    out.append('    ELLIPSE_RADIUS_RATIO != %d || \\' % ELLIPSE_RADIUS_RATIO)
+    out.append('    RAYCAST_FOCAL_LENGTH != %d || \\' % focal_length)
+    out.append('    (defined(PBL_COLOR) && NUM_BACKGROUND_COLORS_PER_SCHEME != %d)'
+               % NUM_BACKGROUND_COLORS_PER_SCHEME)
+    out.append('#error "wall_tables.h is out of date (see '
+               'tools/generate_wall_tables.py)."')
+    out.append('#endif')
+    out.append('')
+
+    # Back wall coordinates:
+    out.append('// Top-left and bottom-right coordinates for every potential '
+               'back wall:')
+    out.append('static const GPoint g_back_wall_coords[MAX_VISIBILITY_DEPTH - '
+               '1]')
+    out.append('                                      [(STRAIGHT_AHEAD * 2) + '
+               '1]')
+    out.append('                                      [2] = {')
+    depths = []
+    for i in range(MAX_VISIBILITY_DEPTH - 1):
+        walls = ['    {{%d, %d}, {%d, %d}}' % (c[0][0], c[0][1], c[1][0],
+                                               c[1][1])
+                 for c in coords[i]]
+        depths.append('  {\n' + ',\n'.join(walls) + '\n  }')
+    out.append(',\n'.join(depths))
+    out.append('};')
+    out.append('')
+
+    # Shading tables:
+    max_top = graphics_frame_height // 2
+    shading_offsets = [get_shading_offset(y) for y in range(max_top + 1)]
+    out.append('// Vertical distance between colored points for a wall column '
+               'whose top is at')
+    out.append('// a given row (or horizontal distance between floor/ceiling '
+               'points):')
+    out.append('static const uint8_t g_shading_offsets[GRAPHICS_FRAME_HEIGHT / '
+               '2 + 1] = {')
+    out.append(format_values(shading_offsets))
+    out.append('};')
+    out.append('#ifdef PBL_COLOR')
+    out.append('// Index into a "g_background_colors" scheme for each entry of '
+               '"g_shading_offsets":')
+    out.append('static const uint8_t g_shading_color_indices[GRAPHICS_FRAME_HEIGHT'
+               ' / 2 + 1] = {')
+    out.append(format_values([min(s, NUM_BACKGROUND_COLORS_PER_SCHEME) - 1
+                              for s in shading_offsets]))
+    out.append('};')
+    out.append('#endif')
+    out.append('')
+
+    # Side walls' on-screen columns:
+    columns, rises, truncated_rises, texture_columns = [], [], [], []
+    for side in (LEFT_WALL, RIGHT_WALL):
+        side_columns = []
+        for depth in range(MAX_VISIBILITY_DEPTH - 1):
+            depth_columns = []
+            for i in range(STRAIGHT_AHEAD + 1):
+                position = i if side == LEFT_WALL else STRAIGHT_AHEAD + i
+                upper_left, upper_right = get_side_wall(coords, width, side,
+                                                        depth, position)
+                first = max(upper_left[0], 0)
+                last = min(upper_right[0], width - 1)
+                num_columns = max(last - first + 1, 0)
+                depth_columns.append('{%d, %d, %d}' % (first, num_columns,
+                                                       len(rises)))
+                for column in range(first, first + num_columns):
+                    rise, truncated_rise = get_rises(upper_left, upper_right,
+                                                     column)
+                    rises.append(rise)
+                    truncated_rises.append(truncated_rise)
+                    texture_columns.append(get_texture_column(
+                        coords, graphics_frame_height, depth,
+                        get_exact_top(upper_left, upper_right, column)))
+            side_columns.append('    {' + ', '.join(depth_columns) + '}')
+        columns.append('  {\n' + ',\n'.join(side_columns) + '\n  }')
+    out.append('// On-screen columns of every potential side wall (indexed by '
+               'side, depth and')
+    out.append('// position, counting outward from straight ahead):')
+    out.append('static const wall_columns_t g_side_wall_columns[NUM_SIDE_WALLS]')
+    out.append('                                               '
+               '[MAX_VISIBILITY_DEPTH - 1]')
+    out.append('                                               '
+               '[STRAIGHT_AHEAD + 1] = {')
+    out.append(',\n'.join(columns))
+    out.append('};')
+    out.append('')
+    out.append('// How far the top edge of a side wall has risen (or fallen) '
+               'at each of its')
+    out.append('// on-screen columns, rounded down and rounded toward zero:')
+    out.append('static const int8_t g_side_wall_rises[%d] = {' % len(rises))
+    out.append(format_values(rises))
+    out.append('};')
+    out.append('static const int8_t g_side_wall_truncated_rises[%d] = {' %
+               len(truncated_rises))
+    out.append(format_values(truncated_rises))
+    out.append('};')
+    out.append('// Texture column at each of those columns (see '
+               '"draw_textured_wall_column"):')
+    out.append('static const uint8_t g_side_wall_texture_columns[%d] = {' %
+               len(texture_columns))
+    out.append(format_values(texture_columns))
+    out.append('};')
+    out.append('')
+
+    # Entrance and exit markers:
+    radii = [get_ellipse_radii(coords, i)
+             for i in range(MAX_VISIBILITY_DEPTH - 1)]
+    max_v_radius = max(v for h, v in radii)
+    out.append('// Horizontal and vertical radii of the entrance and exit '
+               'markers at each depth:')
+    out.append('static const GSize g_ellipse_radii[MAX_VISIBILITY_DEPTH - 1] '
+               '= {')
+    out.append('  ' + ', '.join('{%d, %d}' % r for r in radii))
+    out.append('};')
+    out.append('')
+    out.append('// Half-width of each row of those markers, indexed by depth '
+               'and by vertical')
+    out.append('// distance from the center (rows at or beyond the vertical '
+               'radius are unused):')
+    out.append('static const uint8_t g_ellipse_half_widths'
+               '[MAX_VISIBILITY_DEPTH - 1][%d] = {' % max_v_radius)
+    out.append(',\n'.join('  {' + ', '.join(
+        '%d' % (get_ellipse_half_width(h, v, dy) if dy < v else 0)
+        for dy in range(max_v_radius)) + '}' for h, v in radii))
+    out.append('};')
+    out.append('')
+
+    # Visible widths:
+    out.append('// No. of positions on either side of straight ahead that can '
+               'appear on-screen at')
+    out.append('// each depth:')
+    out.append('static const int8_t g_visible_half_widths'
+               '[MAX_VISIBILITY_DEPTH - 1] = {')
+    out.append(format_values([get_visible_half_width(coords, width, i)
+                              for i in range(MAX_VISIBILITY_DEPTH - 1)]))
+    out.append('};')
+    out.append('')
+
+    # Raycaster floor distances:
+    out.append('#ifdef RAYCASTING_ENGINE_ENABLED')
+    out.append('// Q16 distance (in cells) to the floor point seen at each row '
+               'below the horizon')
+    out.append('// by the raycaster (and, mirrored, to the ceiling point seen '
+               'above it):')
+    out.append('static const int32_t g_floor_distances[GRAPHICS_FRAME_HEIGHT / '
+               '2 + 1] = {')
+    out.append(format_values([(focal_length << FIXED_POINT_SHIFT) // (2 * i + 1)
+                              for i in range(graphics_frame_height // 2 + 1)],
+                             per_line=6))
+    out.append('};')
+    out.append('#endif')
+    out.append('')
+    out.append('#endif  // WALL_TABLES_H_')
+    sys.stdout.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
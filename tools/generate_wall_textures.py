@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+"""
+   Filename: generate_wall_textures.py
+
+Description: Generator for MazeCrawler's optional wall textures (brick and
+             stone), which are stored as raw resources in "resources/data".
+             Each texture holds one prescaled mip level per depth short of
+             "LOW_DETAIL_DEPTH" (farther walls being drawn flat), so a back
+             wall at a given depth is drawn from its mip pixel for pixel (and a
+             side wall from the mip of its far edge). Only color platforms use
+             them. Rerun this whenever the screen size or wall geometry
+             changes:
+
+                 generate_wall_textures.py <screen width> <screen height> \\
+                                           <status bar height> \\
+                                           <max. visibility depth> \\
+                                           <output directory> [<platform>]
+
+             Given a platform, the files are tagged with its name (e.g.,
+             "wall_texture_brick~chalk.bin"), so the SDK uses them in place
+             of the untagged ones on that platform only.
+
+             Resource format (all values unsigned bytes):
+
+                 no. of mip levels
+                 tile width, tile height (per level)
+                 texels (per level), column by column, four 2-bit texels per
+                     byte (lowest bits first), each column padded to a whole
+                     byte
+
+             A tile spans half a cell's width and half its height (one brick
+             and two courses), and texel values are "MORTAR_TEXEL",
+             "SHADOW_TEXEL", "FACE_TEXEL" and "HIGHLIGHT_TEXEL" (see
+             "src/maze_crawler.h").
+"""
+
+import os
+import sys
+
+from generate_wall_tables import (BOTTOM_RIGHT, TOP_LEFT,
+                                  get_back_wall_coords,
+                                  get_graphics_frame_height,
+                                  get_num_detailed_depths,
+                                  set_status_bar_height,
+                                  set_visibility_depth)
+
+MORTAR_TEXEL, SHADOW_TEXEL, FACE_TEXEL, HIGHLIGHT_TEXEL = range(4)
+TEXTURE_NAMES = ('brick', 'stone')
+
+
+def get_tile_size(coords, depth):
+    """Returns the width and height of a tile at a given depth."""
+    top_left, bottom_right = coords[depth][len(coords[depth]) // 2]
+
+    return ((bottom_right[0] - top_left[0]) // 2,
+            (bottom_right[1] - top_left[1]) // 2)
+
+
+def get_speckle(u, v):
+    """Returns a repeatable pseudo-random value in [0, 256) for a point given
+    in 1/32nds of a tile (so every mip level shares the same speckles)."""
+    n = (u * 73856093) ^ (v * 19349663)
+
+    return (n ^ (n >> 13)) & 0xFF
+
+
+def get_brick_texel(u, v, width, height):
+    """Returns the texel at column "u" and row "v" of a brick tile: two
+    courses of running bond, lit from the upper left."""
+    course_height = height // 2
+    course, row = divmod(v, course_height)
+    joint = 0 if course == 0 else width // 2
+    column = (u - joint) % width
+    if row == 0 or column == 0:
+        return MORTAR_TEXEL
+    if row == 1 or column == 1:
+        return HIGHLIGHT_TEXEL
+    if row == course_height - 1 or column == width - 1:
+        return SHADOW_TEXEL
+
+    return FACE_TEXEL
+
+
+def get_stone_texel(u, v, width, height):
+    """Returns the texel at column "u" and row "v" of a stone tile: uneven
+    courses of irregular blocks with speckled faces."""
+    first_course_height = height * 3 // 5
+    if v < first_course_height:
+        row, course_height, joints = v, first_course_height, (0, width * 5 // 9)
+    else:
+        row, course_height = v - first_course_height, height - first_course_height
+        joints = (width * 2 // 9, width * 7 // 9)
+    if row == 0 or u in joints:
+        return MORTAR_TEXEL
+    if row == course_height - 1 or (u + 1) % width in joints:
+        return SHADOW_TEXEL
+    speckle = get_speckle(u * 32 // width, v * 32 // height)
+    if speckle < 40:
+        return SHADOW_TEXEL
+    if speckle > 220 or row == 1:
+        return HIGHLIGHT_TEXEL
+
+    return FACE_TEXEL
+
+
+def pack_tile(get_texel, width, height):
+    """Returns a tile's texels, column by column, four per byte."""
+    data = bytearray()
+    for u in range(width):
+        column = [get_texel(u, v, width, height) for v in range(height)]
+        column += [MORTAR_TEXEL] * (-len(column) % 4)
+        for i in range(0, len(column), 4):
+            data.append(column[i] | column[i + 1] << 2 |
+                        column[i + 2] << 4 | column[i + 3] << 6)
+
+    return data
+
+
+def main():
+    width, height = int(sys.argv[1]), int(sys.argv[2])
+    set_status_bar_height(int(sys.argv[3]))
+    set_visibility_depth(int(sys.argv[4]))
+    coords = get_back_wall_coords(width, get_graphics_frame_height(height))
+    sizes = [get_tile_size(coords, i)
+             for i in range(get_num_detailed_depths())]
+    for name, get_texel in zip(TEXTURE_NAMES,
+                               (get_brick_texel, get_stone_texel)):
+        data = bytearray([len(sizes)])
+        for tile_width, tile_height in sizes:
+            data += bytearray([tile_width, tile_height])
+        for tile_width, tile_height in sizes:
+            data += pack_tile(get_texel, tile_width, tile_height)
+        tag = '~' + sys.argv[6] if len(sys.argv) > 6 else ''
+        path = os.path.join(sys.argv[5], 'wall_texture_%s%s.bin' % (name, tag))
+        with open(path, 'wb') as f:
+            f.write(data)
+
+
+if __name__ == '__main__':
+    main()